@@ -0,0 +1,626 @@
+/* benchmark.cpp
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ea/evolutionary_algorithm.h>
+#include <ea/digital_evolution.h>
+#include <ea/genome_types/bitstring.h>
+#include <ea/fitness_functions/all_ones.h>
+#include <ea/fitness_functions/nk_model.h>
+#include <ea/generational_models/steady_state.h>
+#include <ea/selection/proportionate.h>
+#include <ea/selection/tournament.h>
+#include <ea/selection/universal_sampling.h>
+#include <ea/selection/truncation.h>
+#include <ea/selection/rank.h>
+#include <ea/checkpoint.h>
+#include <ea/genome_types/chunked_genome.h>
+#include <mkv/markov_network.h>
+using namespace ealib;
+
+/*! Throughput benchmarks for EALib's hot paths.
+
+ Usage: benchmark [min_seconds [filter]]
+
+ Each benchmark is run repeatedly until at least min_seconds (default 1.0) of
+ wall-clock time have elapsed, and only benchmarks whose names contain filter
+ are run.  All random number generators are seeded with fixed values, so that
+ each benchmark performs the same work on every run.
+
+ Results are written to stdout as CSV, one line per benchmark:
+ name,unit,calls,units,seconds,units_per_second
+ */
+
+//! Seed used for all EAs and RNGs in this file.
+const unsigned int SEED=42;
+
+//! Prevents the compiler from discarding benchmarked computations.
+volatile double sink=0.0;
+
+//! Minimum wall-clock time for each benchmark.
+double min_seconds=1.0;
+
+//! Only benchmarks whose names contain this string are run.
+std::string filter;
+
+/*! Construct a Benchmark and call it until min_seconds have elapsed, then
+ write its throughput to stdout.
+
+ Each call to the benchmark returns the number of units of work it performed.
+ */
+template <typename Benchmark>
+void run(const std::string& name, const std::string& unit) {
+    if(name.find(filter) == std::string::npos) {
+        return;
+    }
+    using namespace boost::posix_time;
+    Benchmark f;
+    f(); // warm-up
+
+    std::size_t calls=0;
+    double units=0.0, seconds=0.0;
+    ptime start=microsec_clock::universal_time();
+    do {
+        units += f();
+        ++calls;
+        seconds = (microsec_clock::universal_time() - start).total_microseconds() / 1e6;
+    } while(seconds < min_seconds);
+
+    std::cout << name << "," << unit << "," << calls << "," << units << ","
+    << seconds << "," << (units / seconds) << std::endl;
+}
+
+/* digital evolution, using the logic9 instruction set and tasks
+ */
+struct logic9_lifecycle : default_lifecycle {
+    template <typename EA>
+    void after_initialization(EA& ea) {
+        using namespace ealib::instructions;
+        append_isa<nop_a>(0,ea);
+        append_isa<nop_b>(0,ea);
+        append_isa<nop_c>(0,ea);
+        append_isa<nop_x>(ea);
+        append_isa<mov_head>(ea);
+        append_isa<if_label>(ea);
+        append_isa<h_search>(ea);
+        append_isa<nand>(ea);
+        append_isa<push>(ea);
+        append_isa<pop>(ea);
+        append_isa<ealib::instructions::swap>(ea);
+        append_isa<inc>(ea);
+        append_isa<ealib::instructions::dec>(ea);
+        append_isa<tx_msg>(ea);
+        append_isa<rx_msg>(ea);
+        append_isa<bc_msg>(ea);
+        append_isa<ealib::instructions::rotate>(ea);
+        append_isa<rotate_cw>(ea);
+        append_isa<rotate_ccw>(ea);
+        append_isa<if_less>(ea);
+        append_isa<h_alloc>(ea);
+        append_isa<h_copy>(ea);
+        append_isa<h_divide>(ea);
+        append_isa<fixed_input>(ea);
+        append_isa<output>(ea);
+
+        typedef typename EA::task_library_type::task_ptr_type task_ptr_type;
+        typedef typename EA::resource_ptr_type resource_ptr_type;
+
+        task_ptr_type task_not = make_task<tasks::task_not,catalysts::additive<1> >("not", ea);
+        task_ptr_type task_nand = make_task<tasks::task_nand,catalysts::additive<1> >("nand", ea);
+        task_ptr_type task_and = make_task<tasks::task_and,catalysts::additive<2> >("and", ea);
+        task_ptr_type task_ornot = make_task<tasks::task_ornot,catalysts::additive<2> >("ornot", ea);
+        task_ptr_type task_or = make_task<tasks::task_or,catalysts::additive<2> >("or", ea);
+        task_ptr_type task_andnot = make_task<tasks::task_andnot,catalysts::additive<3> >("andnot", ea);
+        task_ptr_type task_nor = make_task<tasks::task_nor,catalysts::additive<3> >("nor", ea);
+        task_ptr_type task_xor = make_task<tasks::task_xor,catalysts::additive<3> >("xor", ea);
+        task_ptr_type task_equals = make_task<tasks::task_equals,catalysts::additive<4> >("equals", ea);
+
+        task_not->consumes(make_resource("resA", ea));
+        task_nand->consumes(make_resource("resB", ea));
+        task_and->consumes(make_resource("resC", ea));
+        task_ornot->consumes(make_resource("resD", ea));
+        task_or->consumes(make_resource("resE", ea));
+        task_andnot->consumes(make_resource("resF", ea));
+        task_nor->consumes(make_resource("resG", ea));
+        task_xor->consumes(make_resource("resH", ea));
+        task_equals->consumes(make_resource("resI", ea));
+    }
+};
+
+typedef digital_evolution<logic9_lifecycle> logic9_ea;
+
+metadata logic9_md(std::size_t x, std::size_t y) {
+    metadata md;
+    put<POPULATION_SIZE>(x*y,md);
+    put<REPRESENTATION_SIZE>(100,md);
+    put<SPATIAL_X>(x,md);
+    put<SPATIAL_Y>(y,md);
+    put<SCHEDULER_TIME_SLICE>(30,md);
+    put<SCHEDULER_RESOURCE_SLICE>(30,md);
+    put<MUTATION_PER_SITE_P>(0.0075,md);
+    put<RNG_SEED>(SEED,md);
+    return md;
+}
+
+//! Executes every individual in a population of self-replicators for one time slice.
+struct hardware_execute {
+    hardware_execute() : ea(logic9_md(32,32)) {
+        generate_ancestors(selfrep_ancestor(), get<POPULATION_SIZE>(ea), ea);
+    }
+
+    double operator()() {
+        const std::size_t n=get<SCHEDULER_TIME_SLICE>(ea);
+        const std::size_t N=ea.population().size();
+        for(std::size_t i=0; i<N; ++i) {
+            logic9_ea::individual_ptr_type p=ea.population()[i];
+            p->hw().execute(n, p, ea);
+        }
+        
+        // offspring replace their neighbors; prune the dead, as the scheduler would:
+        logic9_ea::population_type next;
+        for(std::size_t i=0; i<ea.population().size(); ++i) {
+            if(ea.population()[i]->alive()) {
+                next.push_back(ea.population()[i]);
+            }
+        }
+        std::swap(ea.population(), next);
+        return static_cast<double>(n*N);
+    }
+
+    logic9_ea ea;
+};
+
+//! Runs whole updates of a 64x64 logic9 world under the given scheduler.
+template <typename Scheduler, unsigned int Threads>
+struct scheduler_update {
+    typedef digital_evolution<logic9_lifecycle, recombination::asexual, Scheduler> ea_type;
+
+    scheduler_update() : ea(logic9_md(64,64)) {
+        put<SCHEDULER_THREADS>(Threads, ea.md());
+        put<SCHEDULER_TILE_SIZE>(8, ea.md());
+        generate_ancestors(selfrep_ancestor(), get<POPULATION_SIZE>(ea), ea);
+        ea.lifecycle().advance_epoch(1, ea);
+    }
+
+    double operator()() {
+        const std::size_t N=ea.population().size();
+        ea.lifecycle().advance_epoch(1, ea);
+        return static_cast<double>(get<SCHEDULER_TIME_SLICE>(ea) * N);
+    }
+
+    ea_type ea;
+};
+
+//! Copies and reinitializes organisms, as happens at every birth.
+struct organism_copy {
+    organism_copy() : ea(logic9_md(32,32)) {
+        generate_ancestors(selfrep_ancestor(), 1, ea);
+        hardware_type& hw=ea.population()[0]->hw();
+        for(int i=0; i<3; ++i) {
+            hw.pushLabelStack(hardware::NOP_A);
+            hw.push_stack(i);
+        }
+        ea.population()[0]->inputs().push_front(1);
+        ea.population()[0]->outputs().push_front(2);
+    }
+
+    double operator()() {
+        const std::size_t n=10000;
+        logic9_ea::individual_type& parent=*ea.population()[0];
+        for(std::size_t i=0; i<n; ++i) {
+            logic9_ea::individual_type offspring(parent);
+            offspring.hw().replicated();
+            sink += offspring.hw().age();
+        }
+        return static_cast<double>(n);
+    }
+
+    typedef logic9_ea::individual_type::hardware_type hardware_type;
+    logic9_ea ea;
+};
+
+//! Checks an organism's latest inputs and output against the logic9 tasks.
+struct check_tasks {
+    check_tasks() : ea(logic9_md(32,32)) {
+        generate_ancestors(selfrep_ancestor(), 1, ea);
+        default_rng_type rng(SEED);
+        for(std::size_t i=0; i<64; ++i) {
+            int x=rng(), y=rng();
+            int z[] = {~x, x&y, x|~y, x^y, rng()};
+            in0[i] = x; in1[i] = y; out0[i] = z[i % 5];
+        }
+    }
+
+    double operator()() {
+        const std::size_t n=10000;
+        logic9_ea::individual_type& org=*ea.population()[0];
+        for(std::size_t i=0; i<n; ++i) {
+            std::size_t j=i % 64;
+            org.inputs().push_front(in1[j]);
+            org.inputs().push_front(in0[j]);
+            org.outputs().push_front(out0[j]);
+            ea.tasklib().check_tasks(org, ea);
+        }
+        sink += org.phenotype().count(0);
+        org.phenotype().clear();
+        return static_cast<double>(n);
+    }
+
+    logic9_ea ea;
+    int in0[64], in1[64], out0[64];
+};
+
+//! Updates a single spatial resource on a 128x128 grid.
+struct spatial_diffusion {
+    spatial_diffusion() : ea(logic9_md(128,128)) {
+        r = make_resource("diffusion", 0.1, 0.5, 1.0, 0.75, 0.1, ea);
+    }
+
+    double operator()() {
+        r->update(1.0);
+        return static_cast<double>(get<SPATIAL_X>(ea) * get<SPATIAL_Y>(ea));
+    }
+
+    logic9_ea ea;
+    logic9_ea::resource_ptr_type r;
+};
+
+/* Markov networks
+ */
+struct markov_network_update {
+    typedef mkv::markov_network< > network_type;
+
+    //! Builds a random network of 64 logic and probabilistic gates.
+    markov_network_update() : N(16,8,40,SEED), rng(SEED) {
+        for(std::size_t i=0; i<64; ++i) {
+            network_type::abstract_gate_ptr p;
+            std::size_t nin=rng(1,5), nout=rng(1,5);
+            if(i % 2) {
+                mkv::logic_gate<default_rng_type>* g=new mkv::logic_gate<default_rng_type>();
+                g->M.resize(1<<nin);
+                for(std::size_t j=0; j<g->M.size(); ++j) {
+                    g->M[j] = rng(1<<nout);
+                }
+                p.reset(g);
+            } else {
+                mkv::probabilistic_gate<default_rng_type>* g=new mkv::probabilistic_gate<default_rng_type>();
+                g->M.resize(1<<nin, 1<<nout);
+                for(std::size_t j=0; j<g->M.size1(); ++j) {
+                    for(std::size_t k=0; k<g->M.size2(); ++k) {
+                        g->M(j,k) = rng.p();
+                    }
+                }
+                g->normalize();
+                p.reset(g);
+            }
+            p->inputs.resize(nin);
+            p->outputs.resize(nout);
+            for(std::size_t j=0; j<nin; ++j) {
+                p->inputs[j] = rng(N.nstates());
+            }
+            for(std::size_t j=0; j<nout; ++j) {
+                p->outputs[j] = rng(N.ninputs(), N.nstates());
+            }
+            N.gates().push_back(p);
+        }
+        for(std::size_t i=0; i<N.ninputs(); ++i) {
+            N.input(i) = rng.bit();
+        }
+    }
+
+    double operator()() {
+        const std::size_t n=1000;
+        N.update(n);
+        sink += N.output(0);
+        return static_cast<double>(n);
+    }
+
+    network_type N;
+    default_rng_type rng;
+};
+
+/* genetic algorithms
+ */
+typedef evolutionary_algorithm
+< direct<bitstring>
+, all_ones
+, mutation::operators::per_site<mutation::site::bitflip>
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> all_ones_ea;
+
+typedef evolutionary_algorithm
+< direct<bitstring>
+, nk_model< >
+, mutation::operators::per_site<mutation::site::bitflip>
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> nk_ea;
+
+typedef evolutionary_algorithm
+< direct<bitstring>
+, all_ones
+, mutation::operators::per_site<mutation::site::bitflip>
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+, dont_stop
+, fill_population
+, default_lifecycle
+, fitness_trait
+, pooled_individualS
+> pooled_all_ones_ea;
+
+typedef evolutionary_algorithm
+< direct<bitstring>
+, all_ones
+, mutation::operators::geometric_per_site<mutation::site::bitflip>
+, recombination::asexual
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> asexual_ea;
+
+typedef evolutionary_algorithm
+< direct<chunked_genome<int> >
+, all_ones
+, mutation::operators::geometric_per_site<mutation::site::bitflip>
+, recombination::asexual
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> chunked_asexual_ea;
+
+metadata ga_md() {
+    metadata md;
+    put<POPULATION_SIZE>(1024,md);
+    put<STEADY_STATE_LAMBDA>(2,md);
+    put<REPRESENTATION_SIZE>(128,md);
+    put<MUTATION_PER_SITE_P>(0.01,md);
+    put<TOURNAMENT_SELECTION_N>(8,md);
+    put<TOURNAMENT_SELECTION_K>(1,md);
+    put<NK_MODEL_N>(128,md);
+    put<NK_MODEL_K>(4,md);
+    put<FF_RNG_SEED>(SEED,md);
+    put<CHECKPOINT_OFF>(1,md);
+    put<RNG_SEED>(SEED,md);
+    return md;
+}
+
+//! Selects a full population from a population with evaluated fitnesses.
+template <typename Selector>
+struct select_population {
+    select_population() : ea(ga_md()) {
+        generate_initial_population(ea);
+        calculate_fitness(ea.begin(), ea.end(), ea);
+    }
+
+    double operator()() {
+        const std::size_t n=ea.population().size();
+        all_ones_ea::population_type dst;
+        Selector sel(n, ea.population(), ea);
+        sel(ea.population(), dst, n, ea);
+        return static_cast<double>(dst.size());
+    }
+
+    all_ones_ea ea;
+};
+
+//! Selects the top tenth of a population with evaluated fitnesses.
+template <typename Selector>
+struct select_top_tenth : select_population<Selector> {
+    double operator()() {
+        all_ones_ea& ea=this->ea;
+        const std::size_t n=ea.population().size()/10;
+        all_ones_ea::population_type dst;
+        Selector sel(n, ea.population(), ea);
+        sel(ea.population(), dst, n, ea);
+        return static_cast<double>(dst.size());
+    }
+};
+
+//! Replaces half of the population with offspring each update.
+template <typename EA>
+struct offspring_churn {
+    offspring_churn() : ea(ga_md()) {
+        put<STEADY_STATE_LAMBDA>(512,ea);
+        generate_initial_population(ea);
+    }
+
+    double operator()() {
+        ea.update();
+        return static_cast<double>(get<STEADY_STATE_LAMBDA>(ea));
+    }
+
+    EA ea;
+};
+
+//! Creates mutated asexual offspring of a parent with a 10^5-site genome.
+template <typename EA>
+struct asexual_offspring {
+    asexual_offspring() : ea(ga_md()) {
+        put<POPULATION_SIZE>(1,ea);
+        put<REPRESENTATION_SIZE>(100000,ea);
+        put<MUTATION_PER_SITE_P>(0.0001,ea);
+        generate_initial_population(ea);
+    }
+
+    double operator()() {
+        typename EA::population_type parents, offspring;
+        parents.push_back(ea.population()[0]);
+        typename EA::recombination_operator_type rec;
+        for(std::size_t i=0; i<16; ++i) {
+            rec(parents, offspring, ea);
+        }
+        mutate(offspring.begin(), offspring.end(), ea);
+        return static_cast<double>(offspring.size());
+    }
+
+    EA ea;
+};
+
+//! Evaluates NK fitness over the entire population.
+struct nk_evaluation {
+    nk_evaluation() : ea(ga_md()) {
+        generate_initial_population(ea);
+        calculate_fitness(ea.begin(), ea.end(), ea); // builds the nk table
+    }
+
+    double operator()() {
+        for(nk_ea::iterator i=ea.begin(); i!=ea.end(); ++i) {
+            sink += ea.fitness_function()(*i, ea);
+        }
+        return static_cast<double>(ea.population().size());
+    }
+
+    nk_ea ea;
+};
+
+//! Saves (and optionally loads) a checkpoint to and from memory.
+template <checkpoint::archive_format Format, bool Compress, bool Load>
+struct checkpoint_roundtrip {
+    checkpoint_roundtrip() : ea(ga_md()) {
+        generate_initial_population(ea);
+        ea.lifecycle().advance_epoch(10, ea);
+    }
+
+    double operator()() {
+        std::ostringstream out;
+        checkpoint::save(out, ea, Format, Compress);
+        if(Load) {
+            all_ones_ea ea2;
+            std::istringstream in(out.str());
+            checkpoint::load(in, ea2);
+            sink += ea2.population().size();
+        }
+        return static_cast<double>(ea.population().size());
+    }
+
+    all_ones_ea ea;
+};
+
+/* events
+ */
+template <typename EA>
+struct count_evaluations : fitness_evaluated_event<EA> {
+    count_evaluations(EA& ea) : fitness_evaluated_event<EA>(ea) { }
+    virtual ~count_evaluations() { }
+    virtual void operator()(typename EA::individual_type& ind, EA& ea) {
+        sink += 1.0;
+    }
+};
+
+template <std::size_t Listeners>
+struct fitness_evaluated_emit {
+    fitness_evaluated_emit() : ea(ga_md()) {
+        generate_initial_population(ea);
+        for(std::size_t i=0; i<Listeners; ++i) {
+            add_event<count_evaluations>(ea);
+        }
+    }
+
+    double operator()() {
+        const std::size_t n=100000;
+        all_ones_ea::individual_type& ind=*ea.population()[0];
+        for(std::size_t i=0; i<n; ++i) {
+            ea.events().fitness_evaluated(ind, ea);
+        }
+        return static_cast<double>(n);
+    }
+
+    all_ones_ea ea;
+};
+
+/* metadata
+ */
+struct metadata_get_ea {
+    metadata_get_ea() : ea(ga_md()) {
+    }
+
+    double operator()() {
+        const std::size_t n=100000;
+        for(std::size_t i=0; i<n; ++i) {
+            sink += get<POPULATION_SIZE>(ea);
+        }
+        return static_cast<double>(n);
+    }
+
+    all_ones_ea ea;
+};
+
+struct metadata_get_individual {
+    metadata_get_individual() : ea(ga_md()) {
+        generate_initial_population(ea);
+    }
+
+    double operator()() {
+        for(all_ones_ea::iterator i=ea.begin(); i!=ea.end(); ++i) {
+            sink += get<IND_GENERATION>(*i);
+        }
+        return static_cast<double>(ea.population().size());
+    }
+
+    all_ones_ea ea;
+};
+
+int main(int argc, char* argv[]) {
+    if(argc > 1) {
+        min_seconds = boost::lexical_cast<double>(argv[1]);
+    }
+    if(argc > 2) {
+        filter = argv[2];
+    }
+
+    std::cout << "name,unit,calls,units,seconds,units_per_second" << std::endl;
+    run<hardware_execute>("hardware_execute_logic9", "cycles");
+    run<organism_copy>("organism_copy", "copies");
+    run<scheduler_update<weighted_round_robin< >,1> >("scheduler_update_round_robin", "cycles");
+    run<scheduler_update<tiled_weighted_round_robin< >,1> >("scheduler_update_tiled_1", "cycles");
+    run<scheduler_update<tiled_weighted_round_robin< >,4> >("scheduler_update_tiled_4", "cycles");
+    run<scheduler_update<probabilistic< >,1> >("scheduler_update_probabilistic", "cycles");
+    run<check_tasks>("check_tasks_logic9", "checks");
+    run<markov_network_update>("markov_network_update", "updates");
+    run<select_population<selection::tournament< > > >("selection_tournament", "selections");
+    run<select_population<selection::proportionate< > > >("selection_proportionate", "selections");
+    run<select_population<selection::alias_proportionate< > > >("selection_alias_proportionate", "selections");
+    run<select_population<selection::universal_sampling< > > >("selection_universal_sampling", "selections");
+    run<select_top_tenth<selection::truncation> >("selection_truncation", "selections");
+    run<select_top_tenth<selection::rank< > > >("selection_rank", "selections");
+    run<offspring_churn<all_ones_ea> >("offspring_churn_shared", "offspring");
+    run<offspring_churn<pooled_all_ones_ea> >("offspring_churn_pooled", "offspring");
+    run<asexual_offspring<asexual_ea> >("asexual_offspring_vector", "offspring");
+    run<asexual_offspring<chunked_asexual_ea> >("asexual_offspring_chunked", "offspring");
+    run<nk_evaluation>("nk_model_evaluation", "evaluations");
+    run<spatial_diffusion>("spatial_diffusion", "cells");
+    run<checkpoint_roundtrip<checkpoint::xml_format,false,false> >("checkpoint_save_xml", "individuals");
+    run<checkpoint_roundtrip<checkpoint::xml_format,false,true> >("checkpoint_roundtrip_xml", "individuals");
+    run<checkpoint_roundtrip<checkpoint::binary_format,false,false> >("checkpoint_save_binary", "individuals");
+    run<checkpoint_roundtrip<checkpoint::binary_format,false,true> >("checkpoint_roundtrip_binary", "individuals");
+    run<checkpoint_roundtrip<checkpoint::binary_format,true,true> >("checkpoint_roundtrip_binary_gz", "individuals");
+    run<fitness_evaluated_emit<0> >("event_emit_no_listeners", "events");
+    run<fitness_evaluated_emit<1> >("event_emit_one_listener", "events");
+    run<metadata_get_ea>("metadata_get_ea", "gets");
+    run<metadata_get_individual>("metadata_get_individual", "gets");
+    return 0;
+}
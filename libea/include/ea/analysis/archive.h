@@ -108,7 +108,7 @@ namespace ealib {
 			
 			std::cout << "name,fitness" << std::endl;
 			for(typename EA::iterator i=ea.begin(); i!=ea.end(); ++i) {
-				std::cout << get<IND_UNIQUE_NAME>(*i) << "," << ealib::fitness(*i,ea) << std::endl;
+				std::cout << unique_name(*i) << "," << ealib::fitness(*i,ea) << std::endl;
 			}
 		}
 
@@ -151,7 +151,7 @@ namespace ealib {
 			ea.population().swap(input);
 			
 			for(typename EA::iterator i=ea.begin(); i!=ea.end(); ++i) {
-				put<IND_UNIQUE_NAME>(ea.rng().uuid(), *i);
+				i->id() = ea.next_individual_id();
 			}
 			archive::save(get<ARCHIVE_INPUT>(ea), ea.population(), ea);
 		}
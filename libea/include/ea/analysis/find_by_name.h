@@ -22,6 +22,7 @@
 #define _EA_ANALYSIS_FIND_BY_NAME_H_
 
 #include <ea/analysis.h>
+#include <ea/individual_id.h>
 #include <ea/metadata.h>
 
 namespace ealib {
@@ -34,7 +35,7 @@ namespace ealib {
 		template <typename Population, typename EA>
 		typename EA::population_type::iterator find_by_name(const std::string& name, Population& P, EA& ea) {
 			for(typename Population::iterator i=P.begin(); i!=P.end(); ++i) {
-				if(get<IND_UNIQUE_NAME>(**i) == name) {
+				if(unique_name(**i) == name) {
 					return i;
 				}
 			}
@@ -46,7 +47,7 @@ namespace ealib {
 		typename EA::iterator find_by_name(const std::string& name, EA& ea) {
 			return find_by_name(name, ea.population(), ea);
 			for(typename EA::iterator i=ea.begin(); i!=ea.end(); ++i) {
-				if(get<IND_UNIQUE_NAME>(*i) == name) {
+				if(unique_name(*i) == name) {
 					return i;
 				}
 			}
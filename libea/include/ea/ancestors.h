@@ -42,7 +42,7 @@ namespace ealib {
 	void generate_ancestors(RepresentationGenerator g, std::size_t n, EA& ea) {
         // build the placeholder ancestor:
         typename EA::individual_ptr_type ap = ea.make_individual(g(ea));
-		put<IND_UNIQUE_NAME>(ea.rng().uuid(), *ap);
+        ap->id() = ea.next_individual_id();
         put<IND_GENERATION>(-1.0, *ap);
         put<IND_BIRTH_UPDATE>(ea.current_update(), *ap);
         
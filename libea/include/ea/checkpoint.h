@@ -26,6 +26,13 @@ namespace ealib {
 	
 	LIBEA_MD_DECL(CHECKPOINT_OFF, "ea.run.checkpoint_off", int);
 	LIBEA_MD_DECL(CHECKPOINT_NAME, "ea.run.checkpoint_name", std::string);
+	LIBEA_MD_DECL(CHECKPOINT_FORMAT, "ea.run.checkpoint_format", std::string); // "xml" or "binary"
+	LIBEA_MD_DECL(CHECKPOINT_COMPRESS, "ea.run.checkpoint_compress", int);
+    
+    namespace checkpoint {
+        //! Archive formats supported by checkpoints.
+        enum archive_format { xml_format, binary_format };
+    } // checkpoint
 	
 } // ealib
 
@@ -45,7 +52,7 @@ namespace ealib {
 		template <typename EA> void load(std::istream& in, EA& ea) { }
 		template <typename EA> void load(const std::string& filename, EA& ea) { }
         template <typename EA> void load(const std::string& filename, const metadata& md, EA& ea) { }
-		template <typename EA> void save(std::ostream& out, EA& ea) { }
+		template <typename EA> void save(std::ostream& out, EA& ea, archive_format fmt=xml_format, bool compress=false) { }
 		template <typename EA> void save(const std::string& filename, EA& ea) { }
 		template <typename EA> void save(EA& ea) { }
 	} // checkpoint
@@ -53,12 +60,15 @@ namespace ealib {
 
 #else
 
-#include <boost/regex.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -67,53 +77,161 @@ namespace ealib {
 
 namespace ealib {
 	namespace checkpoint {
+        
+        /*! Binary checkpoints begin with this magic string, followed by the
+         byte layout of the machine that wrote them.  XML checkpoints begin
+         with '<', and gzipped checkpoints (of either format) begin with the
+         gzip magic number, so the first byte of a checkpoint is enough to tell
+         them apart.
+         
+         Binary archives are written in native byte order, and so can only be
+         loaded on a machine with the same layout; load checks this rather than
+         silently producing garbage.
+         */
+        namespace detail {
+            static const char binary_magic[] = "EALIBBIN";
+            static const std::size_t binary_magic_size = 8;
+            static const char gzip_magic = '\x1f';
+            
+            //! Layout of the machine writing (or reading) a binary checkpoint.
+            struct binary_layout {
+                binary_layout() : version(1), size_t_size(sizeof(std::size_t)), long_size(sizeof(long)), double_size(sizeof(double)), byte_order(0x01020304) {
+                }
+                
+                bool operator==(const binary_layout& that) const {
+                    return (version == that.version)
+                    && (size_t_size == that.size_t_size)
+                    && (long_size == that.long_size)
+                    && (double_size == that.double_size)
+                    && (byte_order == that.byte_order);
+                }
+                
+                boost::uint8_t version;
+                boost::uint8_t size_t_size;
+                boost::uint8_t long_size;
+                boost::uint8_t double_size;
+                boost::uint32_t byte_order;
+            };
+            
+            //! Write the binary checkpoint header.
+            inline void write_binary_header(std::ostream& out) {
+                binary_layout l;
+                out.write(binary_magic, binary_magic_size);
+                out.write(reinterpret_cast<const char*>(&l.version), 1);
+                out.write(reinterpret_cast<const char*>(&l.size_t_size), 1);
+                out.write(reinterpret_cast<const char*>(&l.long_size), 1);
+                out.write(reinterpret_cast<const char*>(&l.double_size), 1);
+                out.write(reinterpret_cast<const char*>(&l.byte_order), sizeof(l.byte_order));
+            }
+            
+            //! Read and check the binary checkpoint header.
+            inline void read_binary_header(std::istream& in) {
+                char magic[binary_magic_size];
+                binary_layout l;
+                in.read(magic, binary_magic_size);
+                if(!in.good() || (std::memcmp(magic, binary_magic, binary_magic_size) != 0)) {
+                    throw file_io_exception("checkpoint: bad binary checkpoint header.");
+                }
+                in.read(reinterpret_cast<char*>(&l.version), 1);
+                in.read(reinterpret_cast<char*>(&l.size_t_size), 1);
+                in.read(reinterpret_cast<char*>(&l.long_size), 1);
+                in.read(reinterpret_cast<char*>(&l.double_size), 1);
+                in.read(reinterpret_cast<char*>(&l.byte_order), sizeof(l.byte_order));
+                if(!in.good() || !(l == binary_layout())) {
+                    throw file_io_exception("checkpoint: binary checkpoint was written on an incompatible machine; use XML checkpoints to move between machines.");
+                }
+            }
+            
+        } // detail
+        
+        //! Returns the archive format configured for the given EA (default XML).
+        template <typename EA>
+        archive_format configured_format(EA& ea) {
+            std::string f=get<CHECKPOINT_FORMAT>(ea, "xml");
+            if(f == "xml") {
+                return xml_format;
+            } else if(f == "binary") {
+                return binary_format;
+            }
+            throw bad_argument_exception("checkpoint: unknown checkpoint format " + f + " (expected xml or binary).");
+        }
 		
-		//! Load an EA from the given input stream.
+		/*! Load an EA from the given input stream.
+         
+         The archive format and compression are detected from the first bytes of
+         the stream.
+         */
 		template <typename EA>
 		void load(std::istream& in, EA& ea, const metadata& md=metadata()) {
-			boost::archive::xml_iarchive ia(in);
-			ia >> BOOST_SERIALIZATION_NVP(ea);
+            int c=in.peek();
+            if(c == std::char_traits<char>::to_int_type(detail::gzip_magic)) {
+				namespace bio = boost::iostreams;
+				bio::filtering_stream<bio::input> f;
+				f.push(bio::gzip_decompressor());
+				f.push(in);
+				load(f, ea, md);
+                return;
+            } else if(c == detail::binary_magic[0]) {
+                detail::read_binary_header(in);
+                boost::archive::binary_iarchive ia(in);
+                ia >> BOOST_SERIALIZATION_NVP(ea);
+            } else {
+                boost::archive::xml_iarchive ia(in);
+                ia >> BOOST_SERIALIZATION_NVP(ea);
+            }
 			ea.initialize(md);
 		}
 		
 		//! Load an EA from the given checkpoint file.
 		template <typename EA>
 		void load(const std::string& filename, EA& ea, const metadata& md=metadata()) {
-			std::ifstream ifs(filename.c_str());
+			std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
 			if(!ifs.good()) {
 				throw file_io_exception("could not open " + filename + " for reading.");
 			}
 			std::cerr << "loading " << filename << "... ";
-			
-			// is this a gzipped file?  test by checking file extension...
-			static const boost::regex e(".*\\.gz$");
-			if(boost::regex_match(filename, e)) {
-				namespace bio = boost::iostreams;
-				bio::filtering_stream<bio::input> f;
-				f.push(bio::gzip_decompressor());
-				f.push(ifs);
-				load(f, ea, md);
-			} else {
-				load(ifs, ea, md);
-			}
+            load(ifs, ea, md);
 			std::cerr << "done." << std::endl;
 		}
 		
-		//! Save an EA to the given output stream.
+		//! Save an EA to the given output stream, optionally gzip-compressed.
 		template <typename EA>
-		void save(std::ostream& out, EA& ea) {
-			boost::archive::xml_oarchive oa(out);
-			oa << BOOST_SERIALIZATION_NVP(ea);
+		void save(std::ostream& out, EA& ea, archive_format fmt=xml_format, bool compress=false) {
+            if(compress) {
+				namespace bio = boost::iostreams;
+				bio::filtering_stream<bio::output> f;
+				f.push(bio::gzip_compressor());
+				f.push(out);
+				save(f, ea, fmt, false);
+                return;
+            }
+            
+            switch(fmt) {
+                case binary_format: {
+                    detail::write_binary_header(out);
+                    boost::archive::binary_oarchive oa(out);
+                    oa << BOOST_SERIALIZATION_NVP(ea);
+                    break;
+                }
+                case xml_format:
+                default: {
+                    boost::archive::xml_oarchive oa(out);
+                    oa << BOOST_SERIALIZATION_NVP(ea);
+                    break;
+                }
+            }
 		}
 		
-		//! Save an EA to the given checkpoint file.
+		/*! Save an EA to the given checkpoint file, using the format and
+         compression configured in the EA's metadata.
+         */
 		template <typename EA>
 		void save(const std::string& filename, EA& ea) {
-			std::ofstream ofs(filename.c_str());
+			std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary);
 			if(!ofs.good()) {
 				throw file_io_exception("could not open " + filename + " for writing.");
 			}
-			save(ofs,ea);
+			save(ofs, ea, configured_format(ea), get<CHECKPOINT_COMPRESS>(ea,0) != 0);
 		}
 		
 		//! Save an EA to a generated checkpoint file.
@@ -125,7 +243,9 @@ namespace ealib {
                     fname = get<CHECKPOINT_NAME>(ea);
                 } else {
                     std::ostringstream filename;
-                    filename << "checkpoint-" << ea.current_update() << ".xml";
+                    filename << "checkpoint-" << ea.current_update()
+                    << ((configured_format(ea) == binary_format) ? ".bin" : ".xml")
+                    << (get<CHECKPOINT_COMPRESS>(ea,0) ? ".gz" : "");
                     fname = filename.str();
                 }
                 save(fname, ea);
@@ -136,4 +256,4 @@ namespace ealib {
 } // ealib
 
 #endif
-#endif
\ No newline at end of file
+#endif
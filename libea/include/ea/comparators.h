@@ -90,7 +90,7 @@ namespace ealib {
             }
             
             //! Returns true if attr(x) < attr(y), false otherwise.
-            bool operator()(typename EA::individual_ptr_type x, typename EA::individual_ptr_type y) {
+            bool operator()(const typename EA::individual_ptr_type& x, const typename EA::individual_ptr_type& y) {
                 return _acc(*x,_ea) < _acc(*y,_ea);
             }
             
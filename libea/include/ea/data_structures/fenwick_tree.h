@@ -0,0 +1,155 @@
+/* fenwick_tree.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_DATA_STRUCTURES_FENWICK_TREE_H_
+#define _EA_DATA_STRUCTURES_FENWICK_TREE_H_
+
+#include <cassert>
+#include <vector>
+
+namespace ealib {
+
+    /*! Fenwick tree (binary indexed tree) of weights.
+
+     A fenwick_tree is a sequence of non-negative weights that supports
+     changing, appending, and finding elements by cumulative weight in
+     O(log N) time, e.g., to select elements proportionately to their weight
+     while those weights change.
+
+     Changing a weight adjusts partial sums by the difference between the old
+     and new weights, so with floating-point weights, rounding error
+     accumulates.  rebuild() recomputes all partial sums from the weights.
+     */
+    template <typename T=double>
+    class fenwick_tree {
+    public:
+        typedef T value_type;
+
+        //! Constructs an empty fenwick_tree.
+        fenwick_tree() : _tree(1, T()) {
+        }
+
+        //! Replaces the contents of this tree with the weights in [f,l), in O(N).
+        template <typename ForwardIterator>
+        void assign(ForwardIterator f, ForwardIterator l) {
+            _w.assign(f, l);
+            rebuild();
+        }
+
+        //! Recomputes all partial sums from the weights, in O(N).
+        void rebuild() {
+            _tree.assign(_w.size()+1, T());
+            for(std::size_t i=1; i<_tree.size(); ++i) {
+                _tree[i] += _w[i-1];
+                std::size_t j=i + lowbit(i);
+                if(j < _tree.size()) {
+                    _tree[j] += _tree[i];
+                }
+            }
+        }
+
+        //! Returns the number of weights.
+        std::size_t size() const { return _w.size(); }
+
+        //! Returns true if there are no weights.
+        bool empty() const { return _w.empty(); }
+
+        //! Removes all weights.
+        void clear() {
+            _w.clear();
+            _tree.assign(1, T());
+        }
+
+        //! Reserves space for n weights.
+        void reserve(std::size_t n) {
+            _w.reserve(n);
+            _tree.reserve(n+1);
+        }
+
+        //! Returns the i'th weight.
+        const T& operator[](std::size_t i) const { return _w[i]; }
+
+        //! Appends weight t.
+        void push_back(const T& t) {
+            _w.push_back(t);
+            // the new node covers (i-lowbit(i), i]; sum the nodes covering
+            // (i-lowbit(i), i-1], which already exist:
+            const std::size_t i=_w.size();
+            T s=t;
+            for(std::size_t j=i-1; j>(i-lowbit(i)); j-=lowbit(j)) {
+                s += _tree[j];
+            }
+            _tree.push_back(s);
+        }
+
+        //! Sets the i'th weight to t.
+        void set(std::size_t i, const T& t) {
+            assert(i < _w.size());
+            const T d=t - _w[i];
+            _w[i] = t;
+            for(++i; i<_tree.size(); i+=lowbit(i)) {
+                _tree[i] += d;
+            }
+        }
+
+        //! Returns the sum of the first n weights.
+        T prefix(std::size_t n) const {
+            assert(n <= _w.size());
+            T s=T();
+            for( ; n>0; n-=lowbit(n)) {
+                s += _tree[n];
+            }
+            return s;
+        }
+
+        //! Returns the sum of all weights.
+        T sum() const { return prefix(_w.size()); }
+
+        /*! Returns the index of the first element whose cumulative weight
+         (inclusive) is greater than t, or size() if there is none.
+
+         If t is drawn uniformly from [0, sum()), the index of each element is
+         returned with probability proportional to its weight.
+         */
+        std::size_t find(T t) const {
+            std::size_t i=0;
+            std::size_t step=1;
+            while((step << 1) < _tree.size()) {
+                step <<= 1;
+            }
+            for( ; step>0; step>>=1) {
+                if(((i+step) < _tree.size()) && !(t < _tree[i+step])) {
+                    i += step;
+                    t -= _tree[i];
+                }
+            }
+            return i;
+        }
+
+    protected:
+        //! Returns the lowest set bit of i.
+        static std::size_t lowbit(std::size_t i) { return i & (~i + 1); }
+
+        std::vector<T> _w; //!< Weights.
+        std::vector<T> _tree; //!< Partial sums; 1-based, _tree[i] is the sum of weights (i-lowbit(i), i].
+    };
+
+} // ealib
+
+#endif
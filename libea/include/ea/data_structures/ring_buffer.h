@@ -0,0 +1,202 @@
+/* ring_buffer.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_DATA_STRUCTURES_RING_BUFFER_H_
+#define _EA_DATA_STRUCTURES_RING_BUFFER_H_
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/nvp.hpp>
+
+namespace ealib {
+
+    /*! Fixed-capacity double-ended queue, stored inline.
+
+     ring_buffer supports the subset of std::deque used by digital evolution
+     hardware, but never allocates: its N elements are stored in the object
+     itself, so copying a ring_buffer of trivially-copyable elements is a copy
+     of plain memory.
+
+     Pushing onto a full ring_buffer discards the element at the opposite end,
+     as in boost::circular_buffer; i.e., push_back on a full buffer drops the
+     front, and push_front drops the back.  Callers that should instead drop
+     the new element check full() first.
+
+     See serialize_as_deque (below) for serialization.
+     */
+    template <typename T, std::size_t N>
+    class ring_buffer {
+    public:
+        typedef T value_type;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        //! Random-access iterator over a ring_buffer.
+        template <typename Buffer, typename Value>
+        class iterator_base : public boost::iterator_facade<iterator_base<Buffer,Value>, Value, boost::random_access_traversal_tag> {
+        public:
+            iterator_base() : _b(0), _i(0) { }
+            iterator_base(Buffer* b, std::size_t i) : _b(b), _i(i) { }
+            template <typename B, typename V>
+            iterator_base(const iterator_base<B,V>& that) : _b(that._b), _i(that._i) { }
+
+        private:
+            friend class boost::iterator_core_access;
+            template <typename, typename> friend class iterator_base;
+
+            Value& dereference() const { return (*_b)[_i]; }
+            template <typename B, typename V>
+            bool equal(const iterator_base<B,V>& that) const { return _i == that._i; }
+            void increment() { ++_i; }
+            void decrement() { --_i; }
+            void advance(difference_type n) { _i += n; }
+            template <typename B, typename V>
+            difference_type distance_to(const iterator_base<B,V>& that) const {
+                return static_cast<difference_type>(that._i) - static_cast<difference_type>(_i);
+            }
+
+            Buffer* _b; //!< Buffer being iterated over.
+            std::size_t _i; //!< Logical index of this iterator.
+        };
+
+        typedef iterator_base<ring_buffer, T> iterator;
+        typedef iterator_base<const ring_buffer, const T> const_iterator;
+
+        //! Constructs an empty ring_buffer.
+        ring_buffer() : _head(0), _size(0) {
+        }
+
+        //! Returns the maximum number of elements.
+        static size_type capacity() { return N; }
+
+        //! Returns the number of elements.
+        size_type size() const { return _size; }
+
+        //! Returns true if there are no elements.
+        bool empty() const { return _size == 0; }
+
+        //! Returns true if there are capacity() elements.
+        bool full() const { return _size == N; }
+
+        //! Removes all elements.
+        void clear() { _head = 0; _size = 0; }
+
+        //! Returns the i'th element from the front.
+        reference operator[](size_type i) { assert(i < _size); return _data[wrap(_head + i)]; }
+
+        //! Returns the i'th element from the front (const-qualified).
+        const_reference operator[](size_type i) const { assert(i < _size); return _data[wrap(_head + i)]; }
+
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+        reference back() { return (*this)[_size-1]; }
+        const_reference back() const { return (*this)[_size-1]; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, _size); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, _size); }
+
+        //! Appends t, dropping the front element if full.
+        void push_back(const T& t) {
+            if(full()) {
+                pop_front();
+            }
+            _data[wrap(_head + _size)] = t;
+            ++_size;
+        }
+
+        //! Prepends t, dropping the back element if full.
+        void push_front(const T& t) {
+            if(full()) {
+                pop_back();
+            }
+            _head = wrap(_head + N - 1);
+            _data[_head] = t;
+            ++_size;
+        }
+
+        //! Removes the front element.
+        void pop_front() {
+            assert(_size > 0);
+            _head = wrap(_head + 1);
+            --_size;
+        }
+
+        //! Removes the back element.
+        void pop_back() {
+            assert(_size > 0);
+            --_size;
+        }
+
+        //! Resizes to min(n, capacity()) elements, appending copies of t if growing.
+        void resize(size_type n, const T& t=T()) {
+            n = std::min(n, N);
+            while(_size < n) {
+                push_back(t);
+            }
+            _size = n;
+        }
+
+        //! Returns true if the elements of both ring_buffers are equal.
+        bool operator==(const ring_buffer& that) const {
+            return (_size == that._size) && std::equal(begin(), end(), that.begin());
+        }
+
+        //! Returns true if the elements of the ring_buffers differ.
+        bool operator!=(const ring_buffer& that) const {
+            return !(*this == that);
+        }
+
+    protected:
+        //! Returns the storage index of i, where i < 2N.
+        static size_type wrap(size_type i) { return (i >= N) ? (i - N) : i; }
+
+        T _data[N]; //!< Element storage.
+        size_type _head; //!< Storage index of the front element.
+        size_type _size; //!< Number of elements.
+    };
+
+    /*! Serialize a ring_buffer as though it were a std::deque, so that the two
+     are interchangeable in checkpoints.  When loading, only the last
+     capacity() elements are kept.
+     */
+    template <class Archive, typename T, std::size_t N>
+    void serialize_as_deque(Archive& ar, const char* name, ring_buffer<T,N>& b) {
+        std::deque<T> d;
+        if(Archive::is_saving::value) {
+            d.assign(b.begin(), b.end());
+        }
+        ar & boost::serialization::make_nvp(name, d);
+        if(Archive::is_loading::value) {
+            b.clear();
+            for(typename std::deque<T>::iterator i=d.begin(); i!=d.end(); ++i) {
+                b.push_back(*i);
+            }
+        }
+    }
+
+} // ealib
+
+#endif
@@ -27,7 +27,7 @@
 namespace ealib {
 
     /*! This class is a specialization of std::vector that assumes its members
-     are boost::shared_ptr's.  It is mostly a convenience class for supporting
+     are boost::shared_ptr's (or boost::intrusive_ptr's).  It is mostly a convenience class for supporting
      serialization.
 	 */
 	template <typename T>
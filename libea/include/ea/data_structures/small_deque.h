@@ -0,0 +1,134 @@
+/* small_deque.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_DATA_STRUCTURES_SMALL_DEQUE_H_
+#define _EA_DATA_STRUCTURES_SMALL_DEQUE_H_
+
+#include <cassert>
+#include <deque>
+#include <vector>
+#include <boost/serialization/deque.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <ea/data_structures/ring_buffer.h>
+
+namespace ealib {
+
+    /*! Unbounded queue that stores its first N elements inline.
+
+     small_deque supports appending at the back and removing from the front,
+     like the std::deque it replaces, but holds up to N elements in a
+     ring_buffer stored in the object itself, and only the elements beyond
+     those in a std::vector.  So long as it never holds more than N elements,
+     it never allocates, and copying it is little more than a copy of plain
+     memory.  Unlike ring_buffer, it never discards elements.
+     */
+    template <typename T, std::size_t N>
+    class small_deque {
+    public:
+        typedef T value_type;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+
+        //! Returns the number of elements stored inline.
+        static size_type inline_capacity() { return N; }
+
+        //! Returns the number of elements.
+        size_type size() const { return _inline.size() + _overflow.size(); }
+
+        //! Returns true if there are no elements.
+        bool empty() const { return _inline.empty(); }
+
+        //! Removes all elements.
+        void clear() {
+            _inline.clear();
+            if(!_overflow.empty()) {
+                _overflow.clear();
+            }
+        }
+
+        //! Returns the i'th element from the front.
+        reference operator[](size_type i) {
+            return (i < _inline.size()) ? _inline[i] : _overflow[i - _inline.size()];
+        }
+
+        //! Returns the i'th element from the front (const-qualified).
+        const_reference operator[](size_type i) const {
+            return (i < _inline.size()) ? _inline[i] : _overflow[i - _inline.size()];
+        }
+
+        reference front() { return _inline.front(); }
+        const_reference front() const { return _inline.front(); }
+
+        //! Appends t.
+        void push_back(const T& t) {
+            if(!_inline.full()) {
+                _inline.push_back(t);
+            } else {
+                _overflow.push_back(t);
+            }
+        }
+
+        //! Removes the front element.
+        void pop_front() {
+            assert(!empty());
+            _inline.pop_front();
+            // keep the inline elements at the front:
+            if(!_overflow.empty()) {
+                _inline.push_back(_overflow.front());
+                _overflow.erase(_overflow.begin());
+            }
+        }
+
+        //! Returns true if the elements of both small_deques are equal.
+        bool operator==(const small_deque& that) const {
+            return (_inline == that._inline) && (_overflow == that._overflow);
+        }
+
+        //! Returns true if the elements of the small_deques differ.
+        bool operator!=(const small_deque& that) const {
+            return !(*this == that);
+        }
+
+    protected:
+        ring_buffer<T,N> _inline; //!< The first N elements.
+        std::vector<T> _overflow; //!< Elements beyond the first N.
+    };
+
+    //! Serialize a small_deque as though it were a std::deque (see ring_buffer.h).
+    template <class Archive, typename T, std::size_t N>
+    void serialize_as_deque(Archive& ar, const char* name, small_deque<T,N>& b) {
+        std::deque<T> d;
+        if(Archive::is_saving::value) {
+            for(std::size_t i=0; i<b.size(); ++i) {
+                d.push_back(b[i]);
+            }
+        }
+        ar & boost::serialization::make_nvp(name, d);
+        if(Archive::is_loading::value) {
+            b.clear();
+            for(typename std::deque<T>::iterator i=d.begin(); i!=d.end(); ++i) {
+                b.push_back(*i);
+            }
+        }
+    }
+
+} // ealib
+
+#endif
@@ -81,15 +81,23 @@ namespace ealib {
         
         
         /*! Datafile for meta pop fitness evaluations.
+         
+         This datafile is attached to every subpopulation, and reads all of
+         them each time it records, so it can not be used when subpopulations
+         are updated concurrently (see generational_models::isolated_subpopulations);
+         it throws if METAPOPULATION_THREADS is greater than one.
          */
         template <typename EA>
         struct meta_population_fitness_evaluations : event {
             
             meta_population_fitness_evaluations(EA& ea) : _ea(ea), _df("fitness_evaluations.dat"), _evals(0) {
+                if(get<METAPOPULATION_THREADS>(ea,1) > 1) {
+                    throw fatal_error_exception("meta_population_fitness_evaluations: incompatible with METAPOPULATION_THREADS > 1.");
+                }
                 _connections.resize(get<METAPOPULATION_SIZE>(ea));
                 
                 for(std::size_t i=0; i<get<METAPOPULATION_SIZE>(ea); ++i) {
-                    _connections[i] = ea[i].events().fitness_evaluated.connect(boost::bind(&meta_population_fitness_evaluations::operator(), this, _1, _2));
+                    _connections[i] = ea[i].events().fitness_evaluated.template connect<meta_population_fitness_evaluations, &meta_population_fitness_evaluations::operator()>(this);
                 }
                 
                 _df.add_field("evaluation")
@@ -100,6 +108,9 @@ namespace ealib {
             }
             
             virtual ~meta_population_fitness_evaluations() {
+                for(std::size_t i=0; i<_connections.size(); ++i) {
+                    _connections[i].disconnect();
+                }
             }
             
             virtual void operator()(typename EA::individual_type::individual_type& ind, typename EA::individual_type& ea) {
@@ -130,7 +141,7 @@ namespace ealib {
             }
             
             EA& _ea;
-            std::vector<boost::signals2::scoped_connection> _connections;
+            std::vector<connection> _connections;
             datafile _df;
             long _evals;
         };
@@ -20,11 +20,15 @@
 #ifndef _EA_DIGITAL_EVOLUTION_H_
 #define _EA_DIGITAL_EVOLUTION_H_
 
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/iterator/indirect_iterator.hpp>
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_member.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/thread/tss.hpp>
+#include <vector>
 
 #include <ea/ancestors.h>
 #include <ea/checkpoint.h>
@@ -114,6 +118,22 @@ namespace ealib {
         typedef boost::indirect_iterator<typename population_type::reverse_iterator> reverse_iterator;
         typedef boost::indirect_iterator<typename population_type::const_reverse_iterator> const_reverse_iterator;
         
+        /*! Per-thread state used while individuals are executed concurrently
+         (see tiled_weighted_round_robin).
+         
+         While this EA is concurrent(), rng() returns the RNG of the calling
+         thread's execution context, and effects that reach beyond an
+         individual's neighborhood (appending offspring to the population,
+         assigning identifiers, and triggering events) are queued in the
+         context via defer().  The scheduler performs queued effects serially
+         once concurrent execution is complete.
+         */
+        struct execution_context {
+            typedef boost::function<void()> deferred_type; //!< Type of a queued effect.
+            rng_type rng; //!< Random number generator.
+            std::vector<deferred_type> deferred; //!< Queued effects, in the order they occurred.
+        };
+        
         /*! Similar to the letter/envelope idiom, here we're defining a type
          that is used to hold the guts of a digital_evolution instance.  The
          problem we're trying to solve here is that we have to provide a way
@@ -127,11 +147,13 @@ namespace ealib {
         class state_type {
         public:
             //! Default constructor.
-            state_type() : update(0) {
+            state_type() : update(0), next_id(first_individual_id(0)), id_stream(0), concurrent(false) {
             }
             
             // assignable:
             unsigned long update; //!< Update number for this EA.
+            individual_id_type next_id; //!< Identifier of the next individual born in this EA.
+            individual_id_type id_stream; //!< Id stream from which identifiers are taken.
             rng_type rng; //!< Random number generator.
             md_type md; //!< Meta-data for this evolutionary algorithm instance.
             stop_condition_type stop; //!< Checks for an early stopping condition.
@@ -147,6 +169,7 @@ namespace ealib {
             population_type population; //!< Population instance.
             environment_type env; //!< Environment object.
             scheduler_type scheduler; //!< Scheduler instance.
+            bool concurrent; //!< Whether individuals are being executed concurrently.
 
         private:
             state_type(const state_type&);
@@ -157,7 +180,7 @@ namespace ealib {
             void serialize(Archive & ar, const unsigned int version) {
                 ar & BOOST_SERIALIZATION_NVP(update);
                 ar & BOOST_SERIALIZATION_NVP(rng);
-                ar & BOOST_SERIALIZATION_NVP(md);
+                detail::serialize_ea_md(ar, "md", next_id, id_stream, md);
                 ar & BOOST_SERIALIZATION_NVP(population);
                 ar & BOOST_SERIALIZATION_NVP(env);
             }
@@ -208,6 +231,8 @@ namespace ealib {
                     // events, isa, etc).  copy the easy parts of state first:
                     _state->update = that._state->update;
                     _state->rng = that._state->rng;
+                    _state->next_id = that._state->next_id;
+                    _state->id_stream = that._state->id_stream;
                     _state->md = that._state->md;
                     _state->stop = that._state->stop;
                     _state->lifecycle = that._state->lifecycle;
@@ -241,7 +266,8 @@ namespace ealib {
                 _state->md = md;
                 
                 if(exists<RNG_SEED>(*this)) {
-                    _state->rng.reset(get<RNG_SEED>(*this));
+                    // a seed of 0 seeds from the clock; save the seed that was used:
+                    put<RNG_SEED>(_state->rng.reset(get<RNG_SEED>(*this)), *this);
                 } else {
                     unsigned int s = _state->rng.seed();
                     _state->rng.reset(s);
@@ -278,8 +304,7 @@ namespace ealib {
 
         //! Resets this EA's RNG seed.
         void reset_rng(unsigned int s) {
-            put<RNG_SEED>(s,*this); // save the seed!
-            _state->rng.reset(s);
+            put<RNG_SEED>(_state->rng.reset(s), *this); // save the seed!
         }
         
         //! Builds an individual from the given representation.
@@ -299,11 +324,49 @@ namespace ealib {
             return _state != 0;
         }
         
+        //! Returns the identifier for the next individual born in this EA.
+        individual_id_type next_individual_id() { return take_individual_id(_state->next_id, _state->id_stream); }
+        
+        //! Restart this EA's individual identifiers in the given id stream.
+        void reset_individual_ids(individual_id_type stream) {
+            _state->id_stream = stream;
+            _state->next_id = first_individual_id(stream);
+        }
+        
         //! Returns the current update of this EA.
         unsigned long current_update() { return _state->update; }
         
-        //! Returns the random number generator.
-        rng_type& rng() { return _state->rng; }
+        //! Returns the random number generator (see execution_context).
+        rng_type& rng() {
+            if(_state->concurrent) {
+                return contexts()->rng;
+            }
+            return _state->rng;
+        }
+        
+        //! Returns true if individuals are being executed concurrently.
+        bool concurrent() const { return _state->concurrent; }
+        
+        /*! Sets whether individuals are being executed concurrently; while true,
+         each thread that executes individuals must have an execution context,
+         and this EA's meta-data may be read, but not written (see
+         metadata::concurrent).
+         */
+        void concurrent(bool c) {
+            _state->concurrent = c;
+            _state->md.concurrent(c);
+        }
+        
+        //! Sets the execution context of the calling thread (0 to unset).
+        static void set_execution_context(execution_context* c) {
+            contexts().reset(c);
+        }
+        
+        //! Queues f in the calling thread's execution context; only valid while concurrent().
+        void defer(const typename execution_context::deferred_type& f) {
+            assert(_state->concurrent);
+            contexts()->deferred.push_back(f);
+        }
         
         //! Returns this EA's meta-data.
         md_type& md() { return _state->md; }
@@ -417,12 +480,31 @@ namespace ealib {
             if(l.second) {
                 _state->env.replace(l.first, offspring, *this);
                 offspring->priority() = parent->priority();
-                _state->population.insert(_state->population.end(), offspring);
-                _state->events.birth(*offspring, *parent, *this);
+                if(_state->concurrent) {
+                    defer(boost::bind(&digital_evolution::born, this, offspring, parent));
+                } else {
+                    born(offspring, parent);
+                }
             }
         }
         
     protected:
+        //! Appends a newly-placed offspring to the population.
+        void born(individual_ptr_type offspring, individual_ptr_type parent) {
+            _state->population.insert(_state->population.end(), offspring);
+            _state->events.birth(*offspring, *parent, *this);
+        }
+        
+        //! Does nothing; execution contexts are owned by the scheduler.
+        static void release_context(execution_context* c) {
+        }
+        
+        //! Returns the execution contexts of all threads.
+        static boost::thread_specific_ptr<execution_context>& contexts() {
+            static boost::thread_specific_ptr<execution_context> c(&digital_evolution::release_context);
+            return c;
+        }
+        
         boost::scoped_ptr<state_type> _state; //!< Pointer to this EA's letter.
         
     private:
@@ -444,6 +526,7 @@ namespace ealib {
                 _state.reset(new state_type());
                 ar & boost::serialization::make_nvp("state", *_state);
                 _state->env.link(*this);
+                _state->scheduler.link(*this);
             }
         }
 		BOOST_SERIALIZATION_SPLIT_MEMBER();
@@ -32,6 +32,7 @@
 #include <ea/algorithm.h>
 #include <ea/metadata.h>
 #include <ea/data_structures/torus2.h>
+#include <ea/digital_evolution/events.h>
 
 namespace ealib {
 
@@ -376,7 +377,7 @@ namespace ealib {
             // kill the occupant of l, if any
             if(l.p) {
                 l.p->alive() = false;
-                ea.events().death(*l.p,ea);
+                trigger_death(l.p, ea);
             }
             l.p = p;
             p->position() = l.position();
@@ -34,23 +34,23 @@ namespace ealib {
         }
         
         //! Called when an individual performs a task.
-        boost::signals2::signal<void(typename EA::individual_type&, // individual
+        event_bus<void(typename EA::individual_type&, // individual
                                      typename EA::task_library_type::task_ptr_type, // task pointer
                                      EA&)> task;
         
         //! Called when an individual participates in a reaction.
-        boost::signals2::signal<void(typename EA::individual_type&, // individual
+        event_bus<void(typename EA::individual_type&, // individual
                                      typename EA::task_library_type::task_ptr_type, // task pointer
                                      double r, // resources consumed
                                      EA&)> reaction;
         
         //! Called when an individual is "born" (immediately after it is placed in the population).
-        boost::signals2::signal<void(typename EA::individual_type&, // individual offspring
+        event_bus<void(typename EA::individual_type&, // individual offspring
                                      typename EA::individual_type&, // individual parent
                                      EA&)> birth;
         
         //! Called when an individual "dies" or is replaced.
-        boost::signals2::signal<void(typename EA::individual_type&, // individual
+        event_bus<void(typename EA::individual_type&, // individual
                                      EA&)> death;
         
     private:
@@ -59,10 +59,41 @@ namespace ealib {
     };
     
     
+    namespace detail {
+        
+        //! Triggers the death event of an individual, which it keeps alive until then.
+        template <typename EA>
+        struct trigger_death {
+            trigger_death(typename EA::individual_ptr_type p, EA& ea) : _p(p), _ea(ea) {
+            }
+            
+            void operator()() {
+                _ea.events().death(*_p, _ea);
+            }
+            
+            typename EA::individual_ptr_type _p; //!< Individual that died.
+            EA& _ea; //!< EA in which the individual died.
+        };
+        
+    } // detail
+    
+    /*! Triggers the death event of individual p; if individuals are being
+     executed concurrently, the event is deferred (see digital_evolution::defer).
+     */
+    template <typename EA>
+    void trigger_death(typename EA::individual_ptr_type p, EA& ea) {
+        if(ea.concurrent()) {
+            ea.defer(detail::trigger_death<EA>(p, ea));
+        } else {
+            ea.events().death(*p, ea);
+        }
+    }
+    
+    
     template <typename EA>
     struct task_event : event {
         task_event(EA& ea) {
-            conn = ea.events().task.connect(boost::bind(&task_event::operator(), this, _1, _2, _3));
+            conn = ea.events().task.template connect<task_event, &task_event::operator()>(this);
         }
         virtual ~task_event() { }
         virtual void operator()(typename EA::individual_type&, // individual
@@ -73,7 +104,7 @@ namespace ealib {
     template <typename EA>
     struct reaction_event : event {
         reaction_event(EA& ea) {
-            conn = ea.events().reaction.connect(boost::bind(&reaction_event::operator(), this, _1, _2, _3, _4));
+            conn = ea.events().reaction.template connect<reaction_event, &reaction_event::operator()>(this);
         }
         virtual ~reaction_event() { }
         virtual void operator()(typename EA::individual_type&, // individual
@@ -85,7 +116,7 @@ namespace ealib {
     template <typename EA>
     struct birth_event : event {
         birth_event(EA& ea) {
-            conn = ea.events().birth.connect(boost::bind(&birth_event::operator(), this, _1, _2, _3));
+            conn = ea.events().birth.template connect<birth_event, &birth_event::operator()>(this);
         }
         virtual ~birth_event() { }
         virtual void operator()(typename EA::individual_type&, // individual offspring
@@ -96,7 +127,7 @@ namespace ealib {
     template <typename EA>
     struct death_event : event {
         death_event(EA& ea) {
-            conn = ea.events().death.connect(boost::bind(&death_event::operator(), this, _1, _2));
+            conn = ea.events().death.template connect<death_event, &death_event::operator()>(this);
         }
         virtual ~death_event() { }
         virtual void operator()(typename EA::individual_type&, // individual
@@ -30,7 +30,7 @@ namespace ealib {
         //! Apaptosis (triggers death) instruction.
         DIGEVO_INSTRUCTION_DECL(apoptosis) {
             p->alive() = false;
-            ea.events().death(*p,ea);
+            trigger_death(p, ea);
             put<APOPTOSIS_STATUS>(1, *p);
         }
         
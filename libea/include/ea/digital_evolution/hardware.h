@@ -22,10 +22,10 @@
 #define _EA_DIGITAL_EVOLUTION_AVIDA_HARDWARE_H_
 
 #include <boost/serialization/nvp.hpp>
-#include <boost/serialization/deque.hpp>
-#include <deque>
 #include <strings.h>
 
+#include <ea/data_structures/ring_buffer.h>
+#include <ea/data_structures/small_deque.h>
 #include <ea/genome_types/circular_genome.h>
 #include <ea/mutation.h>
 
@@ -50,6 +50,14 @@ namespace ealib {
      This class defines the representation and hardware for digital evolution, a
      form of artificial life.
      
+     The data stack and message buffer are fixed-capacity ring_buffers, and
+     the first LABEL_CAPACITY labels are held in a small_deque, all stored
+     inline, so that copying and reinitializing hardware (at every birth)
+     doesn't allocate.  Labels are unbounded; only those beyond
+     LABEL_CAPACITY are stored on the heap.  Messages beyond MESSAGE_CAPACITY
+     are dropped, while pushing onto a full data stack drops its bottom
+     element.
+     
      \todo There are good odds that much can be gained by splitting out status information
      into its own struct, and then have instructions manipulate that directly.
      */
@@ -75,6 +83,14 @@ namespace ealib {
         const static int BX = 1; 
         const static int CX = 2;
         
+        const static std::size_t LABEL_CAPACITY = 16; //!< Label length stored inline.
+        const static std::size_t STACK_CAPACITY = 10; //!< Maximum data stack depth.
+        const static std::size_t MESSAGE_CAPACITY = 10; //!< Maximum queued messages.
+        
+        typedef small_deque<int, LABEL_CAPACITY> label_type;
+        typedef ring_buffer<int, STACK_CAPACITY> stack_type;
+        typedef ring_buffer<std::pair<int,int>, MESSAGE_CAPACITY> message_buffer_type;
+        
         struct abstract_hardware_trace {
             //! Called immediately upon entry to execute().
             virtual void top_half() { }
@@ -137,7 +153,7 @@ namespace ealib {
             bool r = (_repr == that._repr);
             r = r && std::equal(_head_position, _head_position+NUM_HEADS, that._head_position);
             r = r && std::equal(_regfile, _regfile+NUM_REGISTERS, that._regfile);
-            r = r && std::equal(_label_stack.begin(), _label_stack.end(), that._label_stack.begin());
+            r = r && (_label_stack == that._label_stack);
             r = r && (_age == that._age);
             r = r && (_mem_extended == that._mem_extended);
             r = r && (_cost== that._cost);
@@ -165,6 +181,10 @@ namespace ealib {
          1) It's possible that a genome contains no instructions with non-zero cost.
          In this case, after attempting genome-size instruction executions, we mark
          the organism as dead.
+         2) Instructions receive a reference to p, which is a copy of the caller's
+         pointer; this keeps the organism alive for the duration of this call,
+         even if it is replaced in the population, without copying p again for
+         each instruction.
          */
         template <typename EA>
         void execute(std::size_t n, typename EA::individual_ptr_type p, EA& ea) {
@@ -176,12 +196,12 @@ namespace ealib {
             // while we have cycles to spend and we haven't exhausted our attempts
             // at executing an instruction:
             while((n > 0) && (attempts++ < _repr.size())) {
-                // get a pointer to the function object for the current instruction:
-                typename EA::isa_type::inst_ptr_type inst=ea.isa()[_repr[_head_position[IP]]];
+                // the current instruction:
+                const std::size_t inst=_repr[_head_position[IP]];
                 
                 // if cost is zero, we're on a new instruction.  figure out its cost:
                 if(_cost == 0) {
-                    _cost = inst->cost(*this, p, ea);
+                    _cost = ea.isa().cost(inst, *this, p, ea);
                 }
                 
                 // if there's now a cost to be paid, we can spend up to min(n,_cost) cycles.
@@ -195,7 +215,7 @@ namespace ealib {
                 
                 // if cost is again 0, everything's been paid and we should execute the instruction:
                 if(_cost == 0) {
-                    (*inst)(*this, p, ea);
+                    ea.isa()(inst, *this, p, ea);
 //                    if(cb != 0) {
 //                        cb->instruction_executed(_repr[_head_position[IP]]);
 //                    }
@@ -270,7 +290,7 @@ namespace ealib {
             _regfile[pos] = val;
         }
         
-        //! Push a label on the label stack
+        //! Push a label on the label stack.
         void pushLabelStack(int label) { 
             _label_stack.push_back(label);
         }
@@ -328,8 +348,8 @@ namespace ealib {
         
         
         //! Get a label complement
-        std::deque<int> getLabelComplement() {
-            std::deque<int> comp; 
+        label_type getLabelComplement() {
+            label_type comp; 
             
             for(std::size_t i=0; i<_label_stack.size(); ++i) {
                 int comp_label = (_label_stack[i] + 1) % NUM_REGISTERS; 
@@ -342,14 +362,15 @@ namespace ealib {
          
          If the label is found, return the distance to it from the IP,
          otherwise return -1 */
-        int findLabel(const std::deque<int>& label) {
-            if (label.size() > 0) {
+        int findLabel(const label_type& label) {
+            const std::size_t n=label.size();
+            if (n > 0) {
                 int d = 0; 
                 int i = _head_position[IP];
                 int exited;
                 while(true) { 
                     exited = true;
-                    for(std::size_t j=0; j<label.size(); ++j) {
+                    for(std::size_t j=0; j<n; ++j) {
                         int k = advance(i, j); 
                         if(static_cast<int>(_repr[k]) != label[j]) { 
                             exited = false;
@@ -376,7 +397,7 @@ namespace ealib {
         std::pair<int, int> findComplementLabel() {
             std::pair <int, int> retVal;
             if (_label_stack.size() > 0) {
-                std::deque<int> comp = getLabelComplement();
+                label_type comp = getLabelComplement();
                 int dist = findLabel(comp);
                 retVal = std::make_pair(dist, comp.size());
             } else {
@@ -399,12 +420,12 @@ namespace ealib {
         //! Retrieve this hardware's representation (const-qualified).
         const genome_type& repr() const { return _repr; }
 
-        void push_stack(int x) { _stack.push_front(x); while(_stack.size() > 10) { _stack.pop_back(); } }
+        void push_stack(int x) { _stack.push_front(x); }
         bool empty_stack() { return _stack.empty(); }
         int pop_stack() { int x = _stack.front(); _stack.pop_front(); return x; }
         
         void deposit_message(int label, int data) {
-            if(_msgs.size() < 10) {
+            if(!_msgs.full()) {
                 _msgs.push_back(std::make_pair(label,data));
             }
         };
@@ -432,13 +453,13 @@ namespace ealib {
         int _head_position[NUM_HEADS]; //!< Positions of the various heads.
         int _regfile[NUM_REGISTERS]; //!< ...
         
-        std::deque<int> _label_stack;
+        label_type _label_stack;
         int _age;
         bool _mem_extended;
         std::size_t _cost;
         std::size_t _orig_size;
-        std::deque<int> _stack;
-        std::deque<std::pair<int,int> > _msgs;
+        stack_type _stack;
+        message_buffer_type _msgs;
         
     private:
         friend class boost::serialization::access;
@@ -447,13 +468,13 @@ namespace ealib {
             ar & boost::serialization::make_nvp("representation", _repr);
             ar & boost::serialization::make_nvp("head_positions", _head_position);
             ar & boost::serialization::make_nvp("register_file", _regfile);
-            ar & boost::serialization::make_nvp("labels", _label_stack);
+            serialize_as_deque(ar, "labels", _label_stack);
             ar & boost::serialization::make_nvp("age", _age);
             ar & boost::serialization::make_nvp("extended", _mem_extended);
             ar & boost::serialization::make_nvp("cost", _cost);
             ar & boost::serialization::make_nvp("original_size", _orig_size);
-            ar & boost::serialization::make_nvp("stack", _stack);
-            ar & boost::serialization::make_nvp("messages", _msgs);
+            serialize_as_deque(ar, "stack", _stack);
+            serialize_as_deque(ar, "messages", _msgs);
         }
     };
     
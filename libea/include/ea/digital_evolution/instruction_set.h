@@ -25,7 +25,6 @@
 #include <stdexcept>
 #include <limits>
 #include <vector>
-#include <deque>
 
 #include <ea/mutation.h>
 
@@ -34,8 +33,8 @@ template <typename Hardware, typename EA> \
 struct name : ealib::instructions::abstract_instruction<Hardware,EA> { \
 name(std::size_t cost) : ealib::instructions::abstract_instruction<Hardware,EA>(#name,cost) { } \
 virtual ~name() { } \
-virtual void operator()(Hardware& hw, typename EA::individual_ptr_type p, EA& ea); }; \
-template<typename Hardware,typename EA> void name<Hardware,EA>::operator()(Hardware& hw, typename EA::individual_ptr_type p, EA& ea)
+virtual void operator()(Hardware& hw, typename EA::individual_ptr_type& p, EA& ea); }; \
+template<typename Hardware,typename EA> void name<Hardware,EA>::operator()(Hardware& hw, typename EA::individual_ptr_type& p, EA& ea)
 
 
 namespace ealib {
@@ -54,12 +53,12 @@ namespace ealib {
             virtual const std::string& name() { return _name; }
             
             //! Return the cost of this instruction in cycles.
-            virtual std::size_t cost(Hardware& hw, typename EA::individual_ptr_type p, EA& ea) {
+            virtual std::size_t cost(Hardware& hw, typename EA::individual_ptr_type& p, EA& ea) {
                 return _cost;
             }
 
             //! Execute this instruction.
-            virtual void operator()(Hardware& hw, typename EA::individual_ptr_type p, EA& ea) = 0;
+            virtual void operator()(Hardware& hw, typename EA::individual_ptr_type& p, EA& ea) = 0;
             
             std::string _name; //!< Name of this instruction.
             std::size_t _cost; //!< Cost of executing this instruction.
@@ -127,7 +126,7 @@ namespace ealib {
             if(!hw.isLabelStackEmpty()) {
                 // what immediately preceeds the write head...
                 int wh = hw.advance(hw.getHeadLocation(Hardware::WH), -1);
-                std::deque<int> label_comp = hw.getLabelComplement();
+                typename Hardware::label_type label_comp = hw.getLabelComplement();
                 // check through label in reverse order...
                 // most recent label is on the back...
                 for(int i=(label_comp.size() - 1);  i>=0; --i) { 
@@ -574,7 +573,33 @@ namespace ealib {
     } // instructions
 
 
+    namespace detail {
+        
+        /*! Execute an instruction of known type.
+         
+         The qualified call bypasses virtual dispatch, which allows the compiler
+         to inline the instruction body into this function.
+         */
+        template <typename Instruction, typename AbstractInstruction, typename Hardware, typename EA>
+        void execute_instruction(AbstractInstruction& inst, Hardware& hw, typename EA::individual_ptr_type& p, EA& ea) {
+            static_cast<Instruction&>(inst).Instruction::operator()(hw, p, ea);
+        }
+        
+        //! Return the cost of an instruction of known type (see above).
+        template <typename Instruction, typename AbstractInstruction, typename Hardware, typename EA>
+        std::size_t instruction_cost(AbstractInstruction& inst, Hardware& hw, typename EA::individual_ptr_type& p, EA& ea) {
+            return static_cast<Instruction&>(inst).Instruction::cost(hw, p, ea);
+        }
+        
+    } // detail
+
     /*! Instruction set architecture for digital evolution.
+     
+     Instructions are owned via shared pointers in _isa, but are dispatched
+     through a flat table of function pointers that is built as instructions
+     are appended.  Each entry in this table calls its instruction's cost() and
+     operator() directly (i.e., non-virtually), so that executing an instruction
+     neither copies a shared pointer nor goes through the vtable.
      */
     template <typename EA>
     class instruction_set {
@@ -589,6 +614,20 @@ namespace ealib {
         
         typedef std::map<std::string, std::size_t> name_map_type;
         
+        //! Type of function pointer that executes an instruction.
+        typedef void (*execute_fn_type)(inst_type&, hardware_type&, individual_ptr_type&, ea_type&);
+        //! Type of function pointer that returns the cost of an instruction.
+        typedef std::size_t (*cost_fn_type)(inst_type&, hardware_type&, individual_ptr_type&, ea_type&);
+        
+        //! Entry in the dispatch table.
+        struct dispatch_entry {
+            inst_type* inst; //!< Instruction (owned by _isa).
+            execute_fn_type execute; //!< Executes inst.
+            cost_fn_type cost; //!< Returns the cost of inst.
+        };
+        
+        typedef std::vector<dispatch_entry> dispatch_table_type;
+        
         //! Constructor.
         instruction_set() {
         }
@@ -598,6 +637,7 @@ namespace ealib {
         void append(std::size_t cost) {
             boost::shared_ptr<inst_type> p(new Instruction<hardware_type,ea_type>(cost));
             _isa.push_back(p);
+            _table.push_back(make_entry<Instruction<hardware_type,ea_type> >(p.get()));
             _name[p->name()] = _isa.size() - 1;
         }
         
@@ -608,11 +648,19 @@ namespace ealib {
             std::size_t i=operator[](k.name());
             boost::shared_ptr<inst_type> p(new Replacement<hardware_type,ea_type>(cost));
             _isa[i] = p;
+            _table[i] = make_entry<Replacement<hardware_type,ea_type> >(p.get());
         }
         
         //! Execute instruction i.
-        void operator()(std::size_t i, hardware_type& hw, individual_ptr_type p, ea_type& ea) {
-            (*_isa[i])(hw,p,ea);
+        void operator()(std::size_t i, hardware_type& hw, individual_ptr_type& p, ea_type& ea) {
+            const dispatch_entry& e=_table[i];
+            e.execute(*e.inst, hw, p, ea);
+        }
+        
+        //! Returns the cost of instruction i.
+        std::size_t cost(std::size_t i, hardware_type& hw, individual_ptr_type& p, ea_type& ea) {
+            const dispatch_entry& e=_table[i];
+            return e.cost(*e.inst, hw, p, ea);
         }
         
         //! Retrieve a pointer to instruction i.
@@ -634,7 +682,18 @@ namespace ealib {
         std::size_t size() const { return _isa.size(); }
         
     protected:
+        //! Build a dispatch table entry for an instruction of the given type.
+        template <typename Instruction>
+        static dispatch_entry make_entry(inst_type* inst) {
+            dispatch_entry e;
+            e.inst = inst;
+            e.execute = &detail::execute_instruction<Instruction,inst_type,hardware_type,ea_type>;
+            e.cost = &detail::instruction_cost<Instruction,inst_type,hardware_type,ea_type>;
+            return e;
+        }
+        
         isa_type _isa; //!< List of available instructions.
+        dispatch_table_type _table; //!< Dispatch table; _table[i] corresponds to _isa[i].
         name_map_type _name; //<! Map of human-readable instruction names to their index in the ISA.
         
     private:
@@ -24,16 +24,19 @@
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
-#include <boost/serialization/deque.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/mpl/int.hpp>
 #include <fstream>
-#include <deque>
 #include <vector>
 #include <map>
 
+#include <ea/data_structures/ring_buffer.h>
 #include <ea/digital_evolution/environment.h>
 #include <ea/digital_evolution/hardware.h>
+#include <ea/digital_evolution/phenotype.h>
 #include <ea/digital_evolution/schedulers.h>
+#include <ea/individual_id.h>
 #include <ea/metadata.h>
 
 namespace ealib {
@@ -50,17 +53,17 @@ namespace ealib {
         typedef hardware_type::mutation_operator_type mutation_operator_type;
         typedef Traits traits_type;
         typedef metadata md_type;
-		typedef std::map<std::string, double> phenotype_type;
+		typedef task_phenotype phenotype_type;
         typedef int io_type;
-        typedef std::deque<io_type> iobuffer_type;
+        typedef ring_buffer<io_type, 4> iobuffer_type; //!< Most recent inputs or outputs, newest first.
         
 		//! Constructor.
-		organism() : _priority(1.0), _alive(true) {
+		organism() : _priority(1.0), _alive(true), _id(0) {
 		}
         
 		//! Constructor that builds an organism from a representation.
 		organism(const genome_type& r) 
-        : _hw(r), _priority(1.0), _alive(true) {
+        : _hw(r), _priority(1.0), _alive(true), _id(0) {
 		}
         
         //! Copy constructor.
@@ -73,6 +76,7 @@ namespace ealib {
             _outputs = that._outputs;
             _phenotype = that._phenotype;
             _md = that._md;
+            _id = that._id;
         }
         
         //! Assignment operator.
@@ -86,6 +90,7 @@ namespace ealib {
                 _outputs = that._outputs;
                 _phenotype = that._phenotype;
                 _md = that._md;
+                _id = that._id;
             }
             return *this;
         }
@@ -99,7 +104,8 @@ namespace ealib {
             && (_inputs == that._inputs)
             && (_outputs == that._outputs)
             && (_phenotype == that._phenotype)
-            && (_md == that._md);
+            && (_md == that._md)
+            && (_id == that._id);
         }
         
         //! Returns this organism's hardware.
@@ -147,6 +153,12 @@ namespace ealib {
         //! Returns this organism's meta data (const-qualified).
         const metadata& md() const { return _md; }
         
+        //! Returns this organism's identifier.
+        individual_id_type& id() { return _id; }
+        
+        //! Returns this organism's identifier (const-qualified).
+        individual_id_type id() const { return _id; }
+        
         //! Returns this individual's traits.
         traits_type& traits() { return _traits; }
         
@@ -168,6 +180,7 @@ namespace ealib {
         iobuffer_type _outputs; //!< This organism's outputs.
         phenotype_type _phenotype; //!< This organism's phenotype.
         metadata _md; //!< This organism's meta data.
+        individual_id_type _id; //!< This organism's identifier.
         traits_type _traits; //!< This organism's traits.
 
 	private:
@@ -178,13 +191,35 @@ namespace ealib {
             ar & boost::serialization::make_nvp("priority", _priority);
             ar & boost::serialization::make_nvp("position", _position);
             ar & boost::serialization::make_nvp("alive", _alive);
-            ar & boost::serialization::make_nvp("inputs", _inputs);
-            ar & boost::serialization::make_nvp("outputs", _outputs);
-            ar & boost::serialization::make_nvp("phenotype", _phenotype);
-            ar & boost::serialization::make_nvp("metadata", _md);
+            serialize_as_deque(ar, "inputs", _inputs);
+            serialize_as_deque(ar, "outputs", _outputs);
+            if(version > 0) {
+                ar & boost::serialization::make_nvp("phenotype", _phenotype);
+            } else {
+                // phenotypes were once keyed by task name; these are mapped to
+                // task indices by the task library when next used:
+                typename phenotype_type::legacy_map_type phenotype;
+                ar & boost::serialization::make_nvp("phenotype", phenotype);
+                _phenotype.legacy(phenotype);
+            }
+            detail::serialize_individual_md(ar, "metadata", _id, _md);
 		}
 	};
     
 } // ealib
 
+namespace boost {
+    namespace serialization {
+        
+        //! Version 1 organisms have a task-indexed phenotype.
+        template <typename Traits>
+        struct version<ealib::organism<Traits> > {
+            typedef mpl::int_<1> type;
+            typedef mpl::integral_c_tag tag;
+            BOOST_STATIC_CONSTANT(int, value = version::type::value);
+        };
+        
+    } // serialization
+} // boost
+
 #endif
@@ -0,0 +1,175 @@
+/* digital_evolution/phenotype.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_DIGITAL_EVOLUTION_PHENOTYPE_H_
+#define _EA_DIGITAL_EVOLUTION_PHENOTYPE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
+
+namespace ealib {
+
+    /*! Task phenotype of a digital organism.
+
+     Records, for each task in the task library, the number of times that it
+     was performed and the amount of resources its reactions consumed since
+     the organism was last prioritized.  Tasks are identified by their index
+     in the task library (see abstract_task::index()); use
+     task_library::index_of and task_library::phenotype_map for name-based
+     access.
+
+     Records are held in a vector that grows to the largest task index
+     performed, so the phenotype of an organism that hasn't performed any
+     tasks (e.g., a newborn) is empty and free to copy.
+
+     Phenotypes read from older checkpoints identify tasks by name; these are
+     held aside until they are converted to records by the task library (see
+     convert()).
+     */
+    class task_phenotype {
+    public:
+        //! Performance of a single task.
+        struct record {
+            record() : count(0), value(0.0) {
+            }
+
+            bool operator==(const record& that) const {
+                return (count == that.count) && (value == that.value);
+            }
+
+            unsigned int count; //!< Number of times the task was performed.
+            double value; //!< Resources consumed by the task's reactions.
+
+            template <class Archive>
+            void serialize(Archive& ar, const unsigned int version) {
+                ar & boost::serialization::make_nvp("count", count);
+                ar & boost::serialization::make_nvp("value", value);
+            }
+        };
+
+        typedef std::vector<record> record_vector_type;
+        //! Type of phenotypes that identify tasks by name, and record the resources they consumed.
+        typedef std::map<std::string, double> legacy_map_type;
+
+        //! Records that task i was performed, and its reaction consumed r resources.
+        void performed(std::size_t i, double r) {
+            if(i >= _records.size()) {
+                _records.resize(i+1);
+            }
+            ++_records[i].count;
+            _records[i].value += r;
+        }
+
+        //! Returns the number of times task i was performed.
+        unsigned int count(std::size_t i) const {
+            return (i < _records.size()) ? _records[i].count : 0;
+        }
+
+        //! Returns the resources consumed by task i.
+        double value(std::size_t i) const {
+            return (i < _records.size()) ? _records[i].value : 0.0;
+        }
+
+        //! Returns true if any task other than i has consumed resources.
+        bool any_other(std::size_t i) const {
+            for(std::size_t j=0; j<_records.size(); ++j) {
+                if((j != i) && (_records[j].value > 0.0)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //! Returns one more than the largest index of a performed task.
+        std::size_t size() const { return _records.size(); }
+
+        //! Returns true if no tasks have been performed.
+        bool empty() const { return _records.empty(); }
+
+        //! Forget all performed tasks.
+        void clear() {
+            _records.clear();
+            _legacy.clear();
+        }
+
+        //! Sets the tasks performed, identified by name (e.g., from an older checkpoint).
+        void legacy(const legacy_map_type& m) { _legacy = m; }
+
+        //! Returns true if this phenotype holds tasks identified by name.
+        bool has_legacy() const { return !_legacy.empty(); }
+
+        /*! Converts tasks identified by name to records, using the given task
+         library to find each task's index.  Each such task is recorded as
+         having been performed once; tasks that are not in the library are
+         forgotten.
+         */
+        template <typename TaskLibrary>
+        void convert(TaskLibrary& tl) {
+            for(legacy_map_type::iterator i=_legacy.begin(); i!=_legacy.end(); ++i) {
+                std::size_t j=tl.index_of(i->first);
+                if(j < tl.tasks().size()) {
+                    performed(j, i->second);
+                }
+            }
+            _legacy.clear();
+        }
+
+        //! Returns true if the phenotypes are equal.
+        bool operator==(const task_phenotype& that) const {
+            return (_records == that._records) && (_legacy == that._legacy);
+        }
+
+    protected:
+        record_vector_type _records; //!< Records, indexed by task.
+        legacy_map_type _legacy; //!< Tasks identified by name, not yet converted.
+
+    private:
+        friend class boost::serialization::access;
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int version) {
+            ar & boost::serialization::make_nvp("tasks", _records);
+            if(version > 0) {
+                ar & boost::serialization::make_nvp("legacy", _legacy);
+            }
+        }
+    };
+
+} // ealib
+
+namespace boost {
+    namespace serialization {
+
+        //! Version 1 phenotypes include tasks identified by name that have not yet been converted.
+        template <>
+        struct version<ealib::task_phenotype> {
+            typedef mpl::int_<1> type;
+            typedef mpl::integral_c_tag tag;
+            BOOST_STATIC_CONSTANT(int, value = version::type::value);
+        };
+
+    } // serialization
+} // boost
+
+#endif
@@ -78,7 +78,31 @@ namespace ealib {
         }
     };
     
+    namespace detail {
+        
+        //! Applies inheritance from parents to offspring.
+        template <typename EA>
+        struct apply_inheritance {
+            apply_inheritance(typename EA::population_type& parents, typename EA::population_type& offspring, EA& ea)
+            : _parents(parents), _offspring(offspring), _ea(ea) {
+            }
+            
+            void operator()() {
+                inherits(_parents, _offspring, _ea);
+            }
+            
+            typename EA::population_type _parents; //!< Parents.
+            typename EA::population_type _offspring; //!< Offspring.
+            EA& _ea; //!< EA in which the offspring were born.
+        };
+        
+    } // detail
+    
     /*! Replicates a parent p to produce an offspring with representation r.
+     
+     If individuals are being executed concurrently, inheritance (which assigns
+     the offspring's identifier and triggers the inheritance event) is deferred
+     (see digital_evolution::defer).
      */
     template <typename EA>
     void replicate(typename EA::individual_ptr_type p, typename EA::genome_type& r, EA& ea) {
@@ -87,7 +111,11 @@ namespace ealib {
         offspring.push_back(ea.make_individual(r));
         
         mutate(offspring.begin(), offspring.end(), ea);
-        inherits(parents, offspring, ea);
+        if(ea.concurrent()) {
+            ea.defer(detail::apply_inheritance<EA>(parents, offspring, ea));
+        } else {
+            inherits(parents, offspring, ea);
+        }
         
         // parent is always reprioritized...
         ea.tasklib().prioritize(*p,ea);
@@ -23,13 +23,13 @@
 
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/serialization/nvp.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 
 #include <ea/algorithm.h>
 #include <ea/metadata.h>
+#include <ea/thread_pool.h>
 
 
 namespace ealib {
@@ -63,6 +63,29 @@ namespace ealib {
             //! Returns the name of this resource.
             virtual const std::string& name() { return _name; }
             
+            /*! Returns true if consuming this resource only affects the level
+             at the consumer's position (or no level at all), false if it
+             affects the level seen by all individuals.
+             */
+            virtual bool is_local() { return true; }
+            
+            /* The stencil interface below lets resource_vector update the
+             rows of many spatial resources at once (see resource_vector::update).
+             Resources that are not spatial are updated entirely by stencil_begin.
+             */
+            
+            //! Begin an update; called serially before any calls to stencil.
+            virtual void stencil_begin(double delta_t) { update(delta_t); }
+            
+            //! Returns the number of rows to be updated by stencil.
+            virtual std::size_t stencil_rows() { return 0; }
+            
+            //! Update rows [f,l); may be called concurrently for disjoint rows.
+            virtual void stencil(double delta_t, std::size_t f, std::size_t l) { }
+            
+            //! Complete an update; called serially after all calls to stencil.
+            virtual void stencil_end() { }
+            
             std::string _name; //!< Human-readable name of this resource.
         };
         
@@ -114,6 +137,9 @@ namespace ealib {
             //! Returns the current resource level.
             virtual double level(const position_type& pos) { return _level; }
             
+            //! Returns false; all individuals consume from the same level.
+            virtual bool is_local() { return false; }
+            
             //! Updates resource levels based on elapsed time since last update (as a fraction of update length).
             virtual void update(double delta_t) {
                 _level += delta_t * (_inflow - (_outflow * _level));
@@ -146,20 +172,25 @@ namespace ealib {
          the edges of the grid.  To avoid this, we alter the size of the resource
          grid to add a single-cell boundary around the spatial environment.
          
+         Resource levels are stored in contiguous, row-major buffers, and each
+         row of the grid is updated by diffuse_row (below), which the compiler
+         can vectorize.
+         
          \note We assume a 2D discrete Cartesian environment.
          */
         template <typename EA>
         struct spatial : abstract_resource<EA> {
-            typedef boost::numeric::ublas::matrix<double> matrix_type; //!< Type for matrix that will store resource levels.
+            typedef std::vector<double> buffer_type; //!< Type for buffer that will store resource levels.
             
             //! Constructor.
             spatial(const std::string& name, double diffuse, double initial,
                     double inflow, double outflow, double consume, std::size_t x, std::size_t y)
             : abstract_resource<EA>(name)
+            , _nx(x+2), _ny(y+2) // +2 for boundaries!
             , _diffuse(diffuse), _initial(initial), _level(initial)
             , _inflow(inflow), _outflow(outflow), _consume(consume) {
-                _R.resize(x+2,y+2); // +2 for boundaries!
-                _T.resize(x+2,y+2);
+                _R.resize(_nx*_ny);
+                _T.resize(_nx*_ny);
                 reset();
             }
             
@@ -169,7 +200,7 @@ namespace ealib {
             //! Returns the amount of consumed resource.
             virtual double consume(typename EA::individual_type& ind) {
                 position_type& pos = ind.position();
-                double& level = _R(pos.r[0]+1, pos.r[1]+1); // +1 for boundaries!
+                double& level = cell(pos.r[0]+1, pos.r[1]+1); // +1 for boundaries!
                 double r = std::max(0.0, level*_consume);
                 level = std::max(0.0, level-r);
                 return r;
@@ -177,56 +208,91 @@ namespace ealib {
             
             //! Returns the current resource level.
             virtual double level(const position_type& pos) {
-                return _R(pos.r[0]+1, pos.r[1]+1);
+                return cell(pos.r[0]+1, pos.r[1]+1);
+            }
+            
+            //! Returns the resource level at cell (i,j) of the grid (including boundaries).
+            double& cell(std::size_t i, std::size_t j) {
+                return _R[i*_ny + j];
             }
             
             /*! Updates resource levels based on elapsed time since last update
              (as a fraction of update length).
              */
             void update(double delta_t) {
+                stencil_begin(delta_t);
+                stencil(delta_t, 0, stencil_rows());
+                stencil_end();
+            }
+            
+            //! Inflow and outflow along the boundaries.
+            void stencil_begin(double delta_t) {
                 // for stability...
                 assert(delta_t < (1.0/(2.0*_diffuse)));
                 
                 // last row and column indices...
-                std::size_t nx=_R.size1()-1;
-                std::size_t ny=_R.size2()-1;
+                std::size_t nx=_nx-1;
+                std::size_t ny=_ny-1;
                 
                 // inflow to the top row:
                 for(std::size_t i=1; i<nx; ++i) {
-                    _R(i,ny-1) += _inflow;
+                    cell(i,ny-1) += _inflow;
                 }
                 
                 // outflow from the bottom row:
                 for(std::size_t i=1; i<nx; ++i) {
-                    _R(i,1) = std::max(0.0, _R(i,0) - _outflow);
+                    cell(i,1) = std::max(0.0, cell(i,0) - _outflow);
                 }
-                
-                // two loops to evaluate the derivatives in the Laplacian,
-                // and calculating resource levels based on the previous time step:
-                for(std::size_t i=1; i<nx; ++i) {
-                    for(std::size_t j=1; j<ny; ++j) {
-                        double uxx = _R(i+1,j) - 2*_R(i,j) + _R(i-1,j);
-                        double uyy = _R(i,j+1) - 2*_R(i,j) + _R(i,j-1);
-                        _T(i,j) = _R(i,j) + delta_t * _diffuse * (uxx+uyy);
-                    }
+            }
+            
+            //! Returns the number of interior rows.
+            std::size_t stencil_rows() {
+                return _nx - 2;
+            }
+            
+            /*! Evaluate the Laplacian and calculate resource levels based on
+             the previous time step for interior rows [f,l).
+             */
+            void stencil(double delta_t, std::size_t f, std::size_t l) {
+                const double c=delta_t * _diffuse;
+                for(std::size_t i=f+1; i<(l+1); ++i) {
+                    diffuse_row(&_R[(i-1)*_ny], &_R[i*_ny], &_R[(i+1)*_ny], &_T[i*_ny], _ny, c);
                 }
+            }
+            
+            //! Swap in the new resource levels.
+            void stencil_end() {
                 _R.swap(_T);
             }
             
+            /*! Diffuse a single row of length n: out = mid + c * laplacian(mid),
+             where up and down are the neighboring rows.  The first and last
+             elements (boundaries) are not written.
+             */
+            static void diffuse_row(const double* up, const double* mid, const double* down, double* out, std::size_t n, double c) {
+                for(std::size_t j=1; j<(n-1); ++j) {
+                    double uxx = down[j] - 2*mid[j] + up[j];
+                    double uyy = mid[j+1] - 2*mid[j] + mid[j-1];
+                    out[j] = mid[j] + c * (uxx+uyy);
+                }
+            }
+            
             //! Resets resource levels.
             void reset() {
-                _R = boost::numeric::ublas::scalar_matrix<double>(_R.size1(), _R.size2(), _initial);
-                _T = boost::numeric::ublas::scalar_matrix<double>(_R.size1(), _R.size2(), _initial);
+                std::fill(_R.begin(), _R.end(), _initial);
+                std::fill(_T.begin(), _T.end(), _initial);
             }
             
             //! Clears resource levels.
             void clear() {
-                _R = boost::numeric::ublas::scalar_matrix<double>(_R.size1(), _R.size2(), 0.0);
-                _T = boost::numeric::ublas::scalar_matrix<double>(_R.size1(), _R.size2(), 0.0);
+                std::fill(_R.begin(), _R.end(), 0.0);
+                std::fill(_T.begin(), _T.end(), 0.0);
             }
             
-            matrix_type _R; //!< Matrix for current resource levels at each cell.
-            matrix_type _T; //!< Matrix for updating resource levels at each cell.
+            std::size_t _nx; //!< Number of rows, including boundaries.
+            std::size_t _ny; //!< Number of columns, including boundaries.
+            buffer_type _R; //!< Current resource levels at each cell.
+            buffer_type _T; //!< Buffer for updating resource levels at each cell.
             double _diffuse; //!< Diffusion constant for this resource.
             double _initial; //!< Initial resource level
             double _level; //!< Current resource level.
@@ -235,6 +301,24 @@ namespace ealib {
             double _consume; //!< Fraction of resource consumed.
         };
         
+        /*! Task that updates a block of rows of one resource (see resource_vector::update).
+         */
+        template <typename ResourceList>
+        struct stencil_task {
+            typedef std::vector<std::pair<std::size_t, std::pair<std::size_t,std::size_t> > > block_list_type;
+            
+            stencil_task(ResourceList& r, block_list_type& b, double delta_t) : _r(r), _b(b), _delta_t(delta_t) {
+            }
+            
+            void operator()(std::size_t i) {
+                _r[_b[i].first]->stencil(_delta_t, _b[i].second.first, _b[i].second.second);
+            }
+            
+            ResourceList& _r;
+            block_list_type& _b;
+            double _delta_t;
+        };
+        
     } // resources
     
     
@@ -271,20 +355,49 @@ namespace ealib {
             _resources.push_back(r);
         }
         
+        //! Returns true if all resources are local (see abstract_resource::is_local).
+        bool is_local() {
+            for(typename resource_list_type::iterator i=_resources.begin(); i!=_resources.end(); ++i) {
+                if(!(*i)->is_local()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
         //! Individual ind consumes resource r.
         double consume(resource_ptr_type r, typename EA::individual_type& ind) {
             return r->consume(ind);
         }
         
-        //! Updates resource levels based on delta t.
-        void update(double delta_t) {
+        /*! Updates resource levels based on delta t.
+         
+         The interior rows of all spatial resources are divided into blocks,
+         and the blocks of all resources are updated together, using up to the
+         given number of threads.  Results do not depend on the number of threads.
+         */
+        void update(double delta_t, std::size_t threads=1) {
+            static const std::size_t block_rows=16;
+            
+            _blocks.clear();
+            for(std::size_t i=0; i<_resources.size(); ++i) {
+                _resources[i]->stencil_begin(delta_t);
+                std::size_t n=_resources[i]->stencil_rows();
+                for(std::size_t f=0; f<n; f+=block_rows) {
+                    _blocks.push_back(std::make_pair(i, std::make_pair(f, std::min(n, f+block_rows))));
+                }
+            }
+            
+            parallel_for(_blocks.size(), detail::stencil_task<resource_list_type>(_resources, _blocks, delta_t), threads);
+            
             for(typename resource_list_type::iterator i=_resources.begin(); i!=_resources.end(); ++i) {
-                (*i)->update(delta_t);
+                (*i)->stencil_end();
             }
         }
         
     protected:
         resource_list_type _resources; //!< Container for resources.
+        typename detail::stencil_task<resource_list_type>::block_list_type _blocks; //!< Row blocks for the current update.
         
     private:
         resource_vector(const resource_vector&);
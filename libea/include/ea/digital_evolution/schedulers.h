@@ -21,14 +21,23 @@
 #ifndef _EA_SCHEDULERS_H_
 #define _EA_SCHEDULERS_H_
 
+#include <algorithm>
 #include <list>
 #include <map>
+#include <vector>
+#include <ea/data_structures/fenwick_tree.h>
+#include <ea/exceptions.h>
 #include <ea/fitness_function.h>
+#include <ea/thread_pool.h>
 
 namespace ealib {    
     
     LIBEA_MD_DECL(SCHEDULER_TIME_SLICE, "ea.scheduler.time_slice", unsigned int);
     LIBEA_MD_DECL(SCHEDULER_RESOURCE_SLICE, "ea.scheduler.resource_slice", unsigned int);
+    LIBEA_MD_DECL(SCHEDULER_RESOURCE_THREADS, "ea.scheduler.resource_threads", unsigned int);
+    LIBEA_MD_DECL(SCHEDULER_THREADS, "ea.scheduler.threads", unsigned int);
+    LIBEA_MD_DECL(SCHEDULER_TILE_SIZE, "ea.scheduler.tile_size", unsigned int);
+    LIBEA_MD_DECL(SCHEDULER_QUANTUM, "ea.scheduler.quantum", unsigned int);
     
     typedef unary_fitness<double> priority_type; //!< Type for storing priorities.
     
@@ -51,7 +60,24 @@ namespace ealib {
         };
 
     } // access
-
+    
+    namespace detail {
+        
+        //! Prune all dead individuals from the population.
+        template <typename EA>
+        void prune_dead(typename EA::population_type& population, EA& ea) {
+            typename EA::population_type next;
+            next.reserve(get<POPULATION_SIZE>(ea));
+            for(std::size_t i=0; i<population.size(); ++i) {
+                typename EA::individual_ptr_type p=population[i];
+                if(p->alive()) {
+                    next.push_back(p);
+                }
+            }
+            std::swap(population, next);
+        }
+        
+    } // detail
 
     /*! Weighted round-robin scheduler.
      
@@ -90,7 +116,7 @@ namespace ealib {
                 // to a partial resource update:
                 int period=consumed/ncycles_per_period;
                 if(period != last_period) {
-                    ea.resources().update(delta_t);
+                    ea.resources().update(delta_t, get<SCHEDULER_RESOURCE_THREADS>(ea,1));
                     last_period = period;
                 }
                 
@@ -108,32 +134,359 @@ namespace ealib {
                 i = (i+1) % N;
             }
             
-            // prune all dead organisms from the population:
+            detail::prune_dead(population, ea);
+        }
+        
+        //! Link a standing population to this scheduler.
+        template <typename EA>
+        void link(EA& ea) {
+        }
+        
+        accessor_type _acc; //!< Accessor for an individual's priority.
+    };
+    
+    /*! Round-robin scheduler.
+     
+     Executes all organisms in a round-robin fashion, granting each a single
+     CPU instruction per execution.
+     */
+    typedef weighted_round_robin<access::unit_priority> round_robin;
+    
+    /*! Probabilistic scheduler.
+     
+     Repeatedly selects an individual with probability proportional to its
+     priority (merit) and executes it for SCHEDULER_QUANTUM (default 1) CPU
+     cycles, as in Avida's probabilistic scheduler, until the same number of
+     cycles as weighted_round_robin would execute have been consumed.  Unlike
+     weighted_round_robin, offspring may execute during the update in which
+     they are born.
+     
+     Priorities are held in a Fenwick tree parallel to the population, so that
+     each selection, birth, death, and change in priority costs O(log N) time.
+     Offspring are appended to the population, and their priorities added to
+     the tree, as they are born; individuals that die are removed from the tree
+     when next selected; and the priority of an individual is updated after
+     each time that it executes.  Dead individuals are pruned from the
+     population, and the tree compacted to match, at the end of each update.
+     
+     If only rounding error remains in the tree (e.g., all remaining
+     individuals have zero priority), the update ends early.  The tree is
+     rebuilt by link(), which is also called when the population
+     size differs from that at the end of the last update (e.g., after the
+     population is initialized); call it explicitly if the population or
+     priorities are otherwise changed between updates.
+     */
+    template <typename PriorityAccessor=access::priority>
+    struct probabilistic {
+        typedef PriorityAccessor accessor_type;
+        
+        template <typename EA>
+        void operator()(typename EA::population_type& population, EA& ea) {
+            if(_weights.size() != population.size()) {
+                link(ea);
+            }
+            
+            const unsigned int eff_population_size = std::min(static_cast<unsigned int>(population.size()),get<POPULATION_SIZE>(ea));
+            const long budget=get<SCHEDULER_TIME_SLICE>(ea) * eff_population_size;
+            const double delta_t = 1.0/static_cast<double>(get<SCHEDULER_RESOURCE_SLICE>(ea));
+            const long ncycles_per_period = std::max(static_cast<long>(budget * delta_t), 1L);
+            const std::size_t quantum=get<SCHEDULER_QUANTUM>(ea,1);
+            if(quantum == 0) {
+                throw bad_argument_exception("probabilistic: SCHEDULER_QUANTUM must be greater than 0.");
+            }
+            
+            long consumed=0; // total consumed CPU cycles
+            int last_period=-1; // update period
+            bool rebuilt=false; // whether partial sums were recomputed since the last execution
+            
+            while(consumed < budget) {
+                int period=consumed/ncycles_per_period;
+                if(period != last_period) {
+                    ea.resources().update(delta_t, get<SCHEDULER_RESOURCE_THREADS>(ea,1));
+                    last_period = period;
+                }
+                
+                const double total=_weights.sum();
+                if(!(total > 0.0)) {
+                    break; // all individuals are dead
+                }
+                std::size_t i=_weights.find(ea.rng().uniform_real(0.0, total));
+                if((i == _weights.size()) || !(_weights[i] > 0.0)) {
+                    // rounding error left a residue in the partial sums; recompute
+                    // them, and if that has already been done without progress,
+                    // there is nothing left to execute:
+                    if(rebuilt) {
+                        break;
+                    }
+                    _weights.rebuild();
+                    rebuilt = true;
+                    continue;
+                }
+                
+                typename EA::individual_ptr_type p=population[i];
+                if(p->alive()) {
+                    p->execute(quantum, p, ea);
+                    consumed += quantum;
+                    rebuilt = false;
+                }
+                
+                // offspring are appended to the population:
+                for(std::size_t j=_weights.size(); j<population.size(); ++j) {
+                    _weights.push_back(weight(*population[j], ea));
+                }
+                const double w=weight(*p, ea);
+                if(w != _weights[i]) {
+                    _weights.set(i, w);
+                }
+            }
+            
+            // prune the dead, and their weights:
             typename EA::population_type next;
+            std::vector<double> w;
             next.reserve(get<POPULATION_SIZE>(ea));
+            w.reserve(get<POPULATION_SIZE>(ea));
             for(std::size_t i=0; i<population.size(); ++i) {
                 typename EA::individual_ptr_type p=population[i];
                 if(p->alive()) {
                     next.push_back(p);
+                    w.push_back(i < _weights.size() ? _weights[i] : weight(*p, ea));
                 }
             }
             std::swap(population, next);
+            _weights.assign(w.begin(), w.end());
         }
         
-        //! Link a standing population to this scheduler.
+        //! Link a standing population to this scheduler, rebuilding its priorities.
         template <typename EA>
         void link(EA& ea) {
+            std::vector<double> w;
+            w.reserve(ea.population().size());
+            for(std::size_t i=0; i<ea.population().size(); ++i) {
+                w.push_back(weight(*ea.population()[i], ea));
+            }
+            _weights.assign(w.begin(), w.end());
+        }
+        
+        //! Returns the scheduling weight of individual ind.
+        template <typename EA>
+        double weight(typename EA::individual_type& ind, EA& ea) {
+            return ind.alive() ? std::max(static_cast<double>(_acc(ind,ea)), 0.0) : 0.0;
         }
         
         accessor_type _acc; //!< Accessor for an individual's priority.
+        fenwick_tree<double> _weights; //!< Weights of individuals, indexed by their position in the population.
     };
     
-    /*! Round-robin scheduler.
+    namespace detail {
+        
+        //! A rectangular region of the environment, and the individuals in it.
+        template <typename EA>
+        struct scheduler_tile {
+            //! Constructor.
+            scheduler_tile() : cycles(0) {
+            }
+            
+            typename EA::execution_context context; //!< Execution context for this tile.
+            std::vector<typename EA::individual_ptr_type> individuals; //!< Individuals scheduled in this tile.
+            long cycles; //!< CPU cycles executed during the current round.
+        };
+        
+        //! Sets the calling thread's execution context for the lifetime of this object.
+        template <typename EA>
+        struct execution_context_guard {
+            execution_context_guard(typename EA::execution_context& c) {
+                EA::set_execution_context(&c);
+            }
+            
+            ~execution_context_guard() {
+                EA::set_execution_context(0);
+            }
+        };
+        
+        //! Marks an EA as executing individuals concurrently for the lifetime of this object.
+        template <typename EA>
+        struct concurrent_guard {
+            concurrent_guard(EA& ea) : _ea(ea) {
+                _ea.concurrent(true);
+            }
+            
+            ~concurrent_guard() {
+                _ea.concurrent(false);
+            }
+            
+            EA& _ea;
+        };
+        
+        //! Task that executes the individuals in the i'th tile of a color.
+        template <typename EA, typename Accessor>
+        struct execute_tile {
+            typedef std::vector<scheduler_tile<EA> > tile_list_type;
+            
+            execute_tile(tile_list_type& tiles, const std::vector<std::size_t>& color, Accessor& acc, EA& ea)
+            : _tiles(tiles), _color(color), _acc(acc), _ea(ea) {
+            }
+            
+            void operator()(std::size_t i) {
+                scheduler_tile<EA>& t=_tiles[_color[i]];
+                execution_context_guard<EA> g(t.context);
+                for(std::size_t j=0; j<t.individuals.size(); ++j) {
+                    typename EA::individual_ptr_type p=t.individuals[j];
+                    if(p->alive()) {
+                        std::size_t n=static_cast<std::size_t>(_acc(*p,_ea));
+                        p->execute(n, p, _ea);
+                        t.cycles += n;
+                    }
+                }
+            }
+            
+            tile_list_type& _tiles;
+            const std::vector<std::size_t>& _color;
+            Accessor& _acc;
+            EA& _ea;
+        };
+        
+        /*! Divide a dimension of length d into tiles at least s long, returning
+         the tile index of each coordinate; the number of tiles is even, or
+         one if d < 2s.
+         */
+        inline std::size_t tile_dimension(std::size_t d, std::size_t s, std::vector<std::size_t>& index) {
+            std::size_t n=d / s;
+            n -= n % 2;
+            n = std::max(n, static_cast<std::size_t>(1));
+            index.resize(d);
+            for(std::size_t k=0; k<n; ++k) {
+                for(std::size_t i=k*d/n; i<(k+1)*d/n; ++i) {
+                    index[i] = k;
+                }
+            }
+            return n;
+        }
+        
+    } // detail
+    
+    /*! Spatially decomposed, multi-threaded weighted round-robin scheduler.
      
-     Executes all organisms in a round-robin fashion, granting each a single
-     CPU instruction per execution.
+     The environment is divided into a grid of tiles at least SCHEDULER_TILE_SIZE
+     (default 8, minimum 2) locations on a side, with an even number of tiles
+     along each dimension, and the tiles are colored as a 2x2 checkerboard.
+     Tiles of the same color are thus separated by at least two locations.
+     Since an individual only interacts with its Moore neighborhood (e.g.,
+     offspring are placed in, and messages are sent to, neighboring locations),
+     individuals in tiles of the same color can be executed concurrently.
+     
+     Each update proceeds in rounds, during which every individual that was
+     alive at the start of the update is granted a number of CPU cycles equal
+     to its priority, as in weighted_round_robin.  Each round executes the four
+     colors in turn, and the tiles of each color on up to SCHEDULER_THREADS
+     (default 1) threads.  Resources are updated between rounds, according to
+     SCHEDULER_RESOURCE_SLICE, and never while individuals are executing.
+     
+     Each tile has its own RNG, seeded from the EA's RNG at the start of each
+     update, and effects that reach beyond an individual's neighborhood
+     (adding offspring to the population, assigning identifiers, and triggering
+     events) are performed serially, in tile order, after each color has been
+     executed (see digital_evolution::execution_context).  Results therefore
+     depend on the RNG seed and tile size, but not the number of threads;
+     they do, however, differ from those of weighted_round_robin.
+     
+     Instructions must only affect the individual's neighborhood and must not
+     write the EA's meta-data, which is concurrent while tiles are executed
+     (see metadata::concurrent), and any event handlers that affect execution
+     (e.g., by adding costs) will do so when the event is performed, not when
+     it occurs.  If any resource is not local (see abstract_resource::is_local),
+     tiles are executed on a single thread.
      */
-    typedef weighted_round_robin<access::unit_priority> round_robin;
+    template <typename PriorityAccessor=access::priority>
+    struct tiled_weighted_round_robin {
+        typedef PriorityAccessor accessor_type;
+        
+        template <typename EA>
+        void operator()(typename EA::population_type& population, EA& ea) {
+            typedef detail::scheduler_tile<EA> tile_type;
+            typedef std::vector<tile_type> tile_list_type;
+            
+            // tile the environment:
+            const std::size_t s=std::max(get<SCHEDULER_TILE_SIZE>(ea,8), 2u);
+            std::vector<std::size_t> xi, yi;
+            const std::size_t nx=detail::tile_dimension(get<SPATIAL_X>(ea), s, xi);
+            const std::size_t ny=detail::tile_dimension(get<SPATIAL_Y>(ea), s, yi);
+            tile_list_type tiles(nx*ny);
+            std::vector<std::size_t> colors[4];
+            for(std::size_t j=0; j<ny; ++j) {
+                for(std::size_t i=0; i<nx; ++i) {
+                    colors[(i%2) + 2*(j%2)].push_back(j*nx + i);
+                }
+            }
+            
+            // only individuals alive at the start of this update are executed:
+            for(std::size_t i=0; i<population.size(); ++i) {
+                typename EA::individual_ptr_type p=population[i];
+                if(p->alive()) {
+                    tiles[yi[p->position().r[1]]*nx + xi[p->position().r[0]]].individuals.push_back(p);
+                }
+            }
+            for(std::size_t i=0; i<tiles.size(); ++i) {
+                tiles[i].context.rng.reset(ea.rng().seed());
+                std::random_shuffle(tiles[i].individuals.begin(), tiles[i].individuals.end(), tiles[i].context.rng);
+            }
+            
+            std::size_t threads=get<SCHEDULER_THREADS>(ea,1);
+            if(!ea.resources().is_local()) {
+                threads = 1;
+            }
+            
+            const unsigned int eff_population_size = std::min(static_cast<unsigned int>(population.size()),get<POPULATION_SIZE>(ea));
+            const long budget=get<SCHEDULER_TIME_SLICE>(ea) * eff_population_size;
+            const double delta_t = 1.0/static_cast<double>(get<SCHEDULER_RESOURCE_SLICE>(ea));
+            const long ncycles_per_period = std::max(static_cast<long>(budget * delta_t), 1L);
+            
+            long consumed=0; // total consumed CPU cycles
+            int last_period=-1; // update period
+            
+            while(consumed < budget) {
+                int period=consumed/ncycles_per_period;
+                if(period != last_period) {
+                    ea.resources().update(delta_t, get<SCHEDULER_RESOURCE_THREADS>(ea,1));
+                    last_period = period;
+                }
+                
+                long round=0; // CPU cycles consumed during this round
+                for(std::size_t c=0; c<4; ++c) {
+                    {
+                        detail::concurrent_guard<EA> g(ea);
+                        parallel_for(colors[c].size(),
+                                     detail::execute_tile<EA,accessor_type>(tiles, colors[c], _acc, ea),
+                                     threads);
+                    }
+                    
+                    // perform deferred effects serially, in tile order:
+                    for(std::size_t i=0; i<colors[c].size(); ++i) {
+                        tile_type& t=tiles[colors[c][i]];
+                        for(std::size_t j=0; j<t.context.deferred.size(); ++j) {
+                            t.context.deferred[j]();
+                        }
+                        t.context.deferred.clear();
+                        round += t.cycles;
+                        t.cycles = 0;
+                    }
+                }
+                
+                if(round == 0) {
+                    break; // all individuals are dead
+                }
+                consumed += round;
+            }
+            
+            detail::prune_dead(population, ea);
+        }
+        
+        //! Link a standing population to this scheduler.
+        template <typename EA>
+        void link(EA& ea) {
+        }
+        
+        accessor_type _acc; //!< Accessor for an individual's priority.
+    };
 
 } // ealib
 
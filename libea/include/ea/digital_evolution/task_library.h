@@ -20,7 +20,12 @@
 #ifndef _EA_DIGITAL_EVOLUTION_TASK_LIBRARY_H_
 #define _EA_DIGITAL_EVOLUTION_TASK_LIBRARY_H_
 
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/ref.hpp>
 #include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <map>
 #include <string>
 #include <vector>
 #include <ea/metadata.h>
@@ -28,6 +33,25 @@
 
 namespace ealib {
     
+    namespace tasks {
+        
+        /*! Set of two-input logic functions that perform the task defined by
+         Predicate, or 0 if the task isn't a bitwise logic task.
+         
+         A two-input logic function is identified by its truth table t, where
+         bit ((a<<1)|b) of t is the function's output on inputs a and b; e.g.,
+         "a and b" is 0x8.  The set is a 16-bit mask with bit t set for each
+         function t whose bitwise output performs the task.  Tasks with a
+         nonzero set are checked by logic_task_checker rather than their
+         predicate (see task_library::check_tasks).
+         */
+        template <typename Predicate>
+        struct logic_functions {
+            static const unsigned int value=0;
+        };
+        
+    } // tasks
+    
     /*! Abstract base class for all task types.
      
      Tasks depend on the type of resource that they consume/produce.
@@ -36,7 +60,7 @@ namespace ealib {
     struct abstract_task {
         typedef typename EA::resource_ptr_type resource_ptr_type; //!< Pointer to resource for this task.
         
-        abstract_task() : _limit(0.0), _exclusive(false) { }
+        abstract_task() : _limit(0.0), _exclusive(false), _index(0), _functions(0) { }
         
         virtual ~abstract_task() {
         }
@@ -44,6 +68,12 @@ namespace ealib {
         //! Returns the name of this task.
         virtual const std::string& name() = 0;
         
+        //! Returns the index of this task in the task library.
+        std::size_t index() const { return _index; }
+        
+        //! Returns the set of logic functions that perform this task (see tasks::logic_functions).
+        unsigned int functions() const { return _functions; }
+        
         //! Returns true if this task was performed, false otherwise.
         virtual bool check(int in0, int in1, int out0) = 0;
 
@@ -75,17 +105,13 @@ namespace ealib {
             bool r=true;
             
             // check to see if consumption of the associated resource is limited:
-            if(is_limited() && (ind.phenotype()[name()] >= limit())) {
+            if(is_limited() && (ind.phenotype().value(_index) >= limit())) {
                 r = false;
             }
             
             // check to see if this task is exclusive:
-            if(r && is_exclusive()) {
-                for(typename EA::individual_type::phenotype_type::iterator i=ind.phenotype().begin(); i!=ind.phenotype().end(); ++i) {
-                    if((i->first != name()) && (i->second > 0.0)) {
-                        r = false;
-                    }
-                }
+            if(r && is_exclusive() && ind.phenotype().any_other(_index)) {
+                r = false;
             }
 
             return r;
@@ -93,6 +119,8 @@ namespace ealib {
         
         double _limit;
         bool _exclusive;
+        std::size_t _index; //!< Index of this task in the task library.
+        unsigned int _functions; //!< Logic functions that perform this task, if any.
     };
     
 
@@ -109,6 +137,7 @@ namespace ealib {
         
         //! Constructor.
         task(const std::string& name) : _name(name) {
+            this->_functions = tasks::logic_functions<Predicate>::value;
         }
         
         virtual ~task() {
@@ -151,6 +180,93 @@ namespace ealib {
     };
 
     
+    /*! Fused checker for bitwise logic tasks.
+     
+     Rather than evaluating each task's predicate in turn, logic_task_checker
+     determines in a single bit-parallel pass over the inputs and output which
+     of the 16 two-input logic functions could have produced the output, and
+     then looks up the tasks performed by those functions.  The result is a
+     bitmask of performed tasks, indexed by their position in the task library.
+     
+     Only the first MAX_TASKS tasks can be fused; others are checked via their
+     predicates.
+     */
+    class logic_task_checker {
+    public:
+        typedef boost::uint64_t mask_type; //!< Bitmask of tasks.
+        
+        //! Maximum number of tasks that can be fused.
+        static const std::size_t MAX_TASKS=64;
+        
+        //! Constructor.
+        logic_task_checker() : _fused(0) {
+            std::fill(_performed_by, _performed_by+16, 0);
+        }
+        
+        /*! Adds task i, which is performed by the given set of logic functions.
+         Returns true if the task was fused, false otherwise.
+         */
+        bool add(std::size_t i, unsigned int functions) {
+            if((i >= MAX_TASKS) || (functions == 0)) {
+                return false;
+            }
+            mask_type m = static_cast<mask_type>(1) << i;
+            for(unsigned int t=0; t<16; ++t) {
+                if(functions & (1u << t)) {
+                    _performed_by[t] |= m;
+                }
+            }
+            _fused |= m;
+            return true;
+        }
+        
+        //! Returns true if task i is checked by this checker.
+        bool fused(std::size_t i) const {
+            return (i < MAX_TASKS) && ((_fused >> i) & 1);
+        }
+        
+        /*! Returns the set of logic functions (see tasks::logic_functions) whose
+         bitwise output on in0 and in1 is out0.
+         
+         For each of the four input combinations, the bits of out0 at positions
+         where that combination occurs must agree; if they are all 1 (0), only
+         functions whose truth table has that bit set (clear) are consistent.
+         Combinations that don't occur don't constrain the set.
+         */
+        static unsigned int functions(int in0, int in1, int out0) {
+            // functions with bit k of their truth table set, for k=0..3:
+            static const unsigned int with_bit[4] = {0xAAAA, 0xCCCC, 0xF0F0, 0xFF00};
+            const unsigned int a=in0, b=in1, z=out0;
+            const unsigned int occurs[4] = {~a & ~b, ~a & b, a & ~b, a & b};
+            unsigned int f=0xFFFF;
+            for(std::size_t k=0; k<4; ++k) {
+                if(z & occurs[k]) {
+                    f &= with_bit[k];
+                }
+                if(~z & occurs[k]) {
+                    f &= ~with_bit[k];
+                }
+            }
+            return f & 0xFFFF;
+        }
+        
+        //! Returns the bitmask of fused tasks performed by out0 given inputs in0 and in1.
+        mask_type operator()(int in0, int in1, int out0) const {
+            mask_type m=0;
+            for(unsigned int f=functions(in0, in1, out0), t=0; f; f>>=1, ++t) {
+                if(f & 1) {
+                    m |= _performed_by[t];
+                }
+            }
+            return m;
+        }
+        
+    protected:
+        mask_type _performed_by[16]; //!< Tasks performed by each logic function.
+        mask_type _fused; //!< Tasks checked by this checker.
+    };
+    
+    
     /*! Contains the tasks that are active for the current EA.
      */
     template <typename EA>
@@ -162,12 +278,35 @@ namespace ealib {
         typedef std::vector<task_ptr_type> tasklist_type;
         
         //! Default constructor.
-        task_library() {
+        task_library() : _all_fused(true) {
         }
         
         //! Append a task to the task library.
         void append(task_ptr_type p) {
+            p->_index = _tasklist.size();
             _tasklist.push_back(p);
+            _all_fused = _logic.add(p->_index, p->functions()) && _all_fused;
+        }
+        
+        //! Returns the index of the named task, or tasks().size() if there is none.
+        std::size_t index_of(const std::string& name) {
+            std::size_t i=0;
+            for( ; (i<_tasklist.size()) && (_tasklist[i]->name() != name); ++i) { }
+            return i;
+        }
+        
+        /*! Returns the given individual's phenotype keyed by task name, with
+         entries for the tasks that it has performed.
+         */
+        std::map<std::string, double> phenotype_map(individual_type& org) {
+            convert_phenotype(org);
+            std::map<std::string, double> m;
+            for(std::size_t i=0; i<_tasklist.size(); ++i) {
+                if(org.phenotype().count(i) > 0) {
+                    m[_tasklist[i]->name()] = org.phenotype().value(i);
+                }
+            }
+            return m;
         }
 
         //! Retrieve the list of active tasks.
@@ -176,12 +315,13 @@ namespace ealib {
         /*! Updates the priority for the given individual.
          */
         void prioritize(individual_type& org, EA& ea) {
+            convert_phenotype(org);
             priority_type p=1.0;
             
-            for(typename tasklist_type::iterator i=_tasklist.begin(); i!=_tasklist.end(); ++i) {
-                abstract_task_type& task=(**i);
-                if(org.phenotype()[task.name()] > 0.0) {
-                    p = task.catalyze(org.phenotype()[task.name()], p);
+            for(std::size_t i=0; i<org.phenotype().size(); ++i) {
+                double r=org.phenotype().value(i);
+                if(r > 0.0) {
+                    p = _tasklist[i]->catalyze(r, p);
                 }
             }
             
@@ -195,29 +335,33 @@ namespace ealib {
          This works by testing the latest iobuffer entries against all
          tasks in the task library.  For every task performed, the individual's
          phenotype is annotated with the amount of resources consumed.
+         
+         Bitwise logic tasks are all checked at once by a logic_task_checker;
+         any other tasks are checked by their predicates.  Either way, tasks
+         are performed in the order in which they appear in the library.
          */
         void check_tasks(individual_type& org, EA& ea) {
             typedef typename EA::individual_type::iobuffer_type iobuffer_type;
+            typedef logic_task_checker::mask_type mask_type;
             
             iobuffer_type& inputs = org.inputs();
             iobuffer_type& outputs = org.outputs();
             
             if((inputs.size() >= 2) && (!outputs.empty())) {
-                for(typename tasklist_type::iterator i=_tasklist.begin(); i!=_tasklist.end(); ++i) {
-                    abstract_task_type& task=(**i);
-                    if(task.check(inputs[0], inputs[1], outputs[0])) {
-                        // ok, the *task* was performed.
-                        ea.events().task(org, *i, ea);
-                        
-                        if(task.reaction_occurs(org,ea)) {
-                            // if the reaction occurs, consume resources:
-                            double r = task.resource()->consume(org);
-                            org.phenotype()[task.name()] += r;
-                            ea.events().reaction(org, *i, r, ea);
-                        } else {
-                            // if the reaction did not occur, let's still update the
-                            // phenotype to indicate that the task was performed:
-                            org.phenotype()[task.name()] += 0.0;
+                convert_phenotype(org);
+                const int in0=inputs[0], in1=inputs[1], out0=outputs[0];
+                mask_type performed=_logic(in0, in1, out0);
+                
+                if(_all_fused) {
+                    for(std::size_t i=0; performed; performed>>=1, ++i) {
+                        if(performed & 1) {
+                            perform(i, org, ea);
+                        }
+                    }
+                } else {
+                    for(std::size_t i=0; i<_tasklist.size(); ++i) {
+                        if(_logic.fused(i) ? ((performed >> i) & 1) : _tasklist[i]->check(in0, in1, out0)) {
+                            perform(i, org, ea);
                         }
                     }
                 }
@@ -225,7 +369,47 @@ namespace ealib {
         }
         
     protected:
+        //! Converts tasks that the given individual's phenotype identifies by name (see task_phenotype::convert).
+        void convert_phenotype(individual_type& org) {
+            if(org.phenotype().has_legacy()) {
+                org.phenotype().convert(*this);
+            }
+        }
+        
+        /*! Called when the given individual has performed task i; triggers its
+         reaction, if allowed, and records it in the individual's phenotype.
+         
+         Task and reaction events are deferred if individuals are being executed
+         concurrently (see digital_evolution::defer).
+         */
+        void perform(std::size_t i, individual_type& org, EA& ea) {
+            abstract_task_type& task=*_tasklist[i];
+            // ok, the *task* was performed.
+            if(ea.concurrent()) {
+                ea.defer(boost::bind<void>(boost::ref(ea.events().task), boost::ref(org), _tasklist[i], boost::ref(ea)));
+            } else {
+                ea.events().task(org, _tasklist[i], ea);
+            }
+            
+            if(task.reaction_occurs(org,ea)) {
+                // if the reaction occurs, consume resources:
+                double r = task.resource()->consume(org);
+                org.phenotype().performed(i, r);
+                if(ea.concurrent()) {
+                    ea.defer(boost::bind<void>(boost::ref(ea.events().reaction), boost::ref(org), _tasklist[i], r, boost::ref(ea)));
+                } else {
+                    ea.events().reaction(org, _tasklist[i], r, ea);
+                }
+            } else {
+                // if the reaction did not occur, let's still update the
+                // phenotype to indicate that the task was performed:
+                org.phenotype().performed(i, 0.0);
+            }
+        }
+        
         tasklist_type _tasklist; //!< Active tasks.
+        logic_task_checker _logic; //!< Fused checker for bitwise logic tasks.
+        bool _all_fused; //!< Whether all tasks are checked by _logic.
         
     private:
         task_library(const task_library&);
@@ -307,6 +491,19 @@ namespace ealib {
             }  
         };
         
+        /* Logic functions of the logic9 tasks, where a=0xC and b=0xA (see
+         logic_functions):
+         */
+        template <> struct logic_functions<task_not> { static const unsigned int value=(1u<<0x3) | (1u<<0x5); };
+        template <> struct logic_functions<task_nand> { static const unsigned int value=(1u<<0x7); };
+        template <> struct logic_functions<task_and> { static const unsigned int value=(1u<<0x8); };
+        template <> struct logic_functions<task_ornot> { static const unsigned int value=(1u<<0xD) | (1u<<0xB); };
+        template <> struct logic_functions<task_or> { static const unsigned int value=(1u<<0xE); };
+        template <> struct logic_functions<task_andnot> { static const unsigned int value=(1u<<0x4) | (1u<<0x2); };
+        template <> struct logic_functions<task_nor> { static const unsigned int value=(1u<<0x1); };
+        template <> struct logic_functions<task_xor> { static const unsigned int value=(1u<<0x6); };
+        template <> struct logic_functions<task_equals> { static const unsigned int value=(1u<<0x9); };
+        
         //! True: always returns true. (Used for testing)
         struct task_true {
             bool operator()(int in0, int in1, int out0) {
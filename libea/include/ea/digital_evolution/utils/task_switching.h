@@ -47,7 +47,7 @@ using namespace ealib;
 using namespace boost::accumulators;
 
 LIBEA_MD_DECL(TASK_SWITCHING_COST, "ea.ts.task_switching_cost", int);
-LIBEA_MD_DECL(LAST_TASK, "ea.ts.last_task", std::string);
+LIBEA_MD_SLOT_DECL(LAST_TASK, "ea.ts.last_task", int);
 LIBEA_MD_DECL(NUM_SWITCHES, "ea.ts.num_switches", int);
 LIBEA_MD_DECL(GERM_MUTATION_PER_SITE_P, "ea.ts.germ_mutation_per_site_p", double);
 LIBEA_MD_DECL(NUM_GROUP_REPLICATIONS, "ea.ts.num_group_replications", int);
@@ -61,6 +61,23 @@ LIBEA_MD_DECL(RES_FRACTION_CONSUMED, "ea.ts.res_fraction_consumed", double);
 
 
 
+/*! Returns a reference to the index of the last task performed by ind, or -1
+ if it has not performed one.
+ 
+ Checkpoints from before tasks were tracked by index record LAST_TASK as a task
+ name; such a name is converted to its index (or -1, if the task is no longer
+ in the task library) the first time it is read.
+ */
+template <typename EA>
+int& last_task(typename EA::individual_type& ind, EA& ea) {
+    try {
+        return get<LAST_TASK>(ind, -1);
+    } catch(boost::bad_lexical_cast&) {
+        const std::size_t i = ea.tasklib().index_of(ind.md().template getstr<LAST_TASK>(LAST_TASK::key()));
+        return put<LAST_TASK>((i < ea.tasklib().tasks().size()) ? static_cast<int>(i) : -1, ind);
+    }
+}
+
 /*! If an organism changes tasks, then it incurs a task-switching cost.
  */
 
@@ -76,13 +93,14 @@ struct task_switching_cost : reaction_event<EA> {
                             double r, // amount of resource consumed
                             EA& ea) {
         
-        if (exists<LAST_TASK>(ind) && 
-            (task->name() != get<LAST_TASK>(ind, ""))) {
+        const int t = static_cast<int>(task->index());
+        int& last = last_task(ind, ea);
+        if ((last != -1) && (t != last)) {
             
             ind.hw().add_cost(get<TASK_SWITCHING_COST>(ea)); 
             get<NUM_SWITCHES>(ind, 0) += 1; 
         }
-        put<LAST_TASK>(task->name(), ind); 
+        last = t; 
         
     }
 };
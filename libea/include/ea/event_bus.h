@@ -0,0 +1,461 @@
+/* event_bus.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_EVENT_BUS_H_
+#define _EA_EVENT_BUS_H_
+
+#include <algorithm>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace ealib {
+
+    namespace detail {
+
+        //! Type-independent part of an event bus's slot list, used by connections.
+        struct slot_list_base {
+            virtual ~slot_list_base() { }
+            virtual void disconnect(std::size_t id) = 0;
+            virtual bool connected(std::size_t id) const = 0;
+        };
+
+    } // detail
+
+    /*! Handle to a slot connected to an event bus.
+
+     Connections may outlive the bus they refer to; disconnecting such a
+     connection does nothing.
+     */
+    class connection {
+    public:
+        //! Constructs an empty connection.
+        connection() : _id(0) {
+        }
+
+        //! Constructs a connection to slot id in list l.
+        connection(const boost::shared_ptr<detail::slot_list_base>& l, std::size_t id) : _list(l), _id(id) {
+        }
+
+        //! Disconnect this slot from its bus.
+        void disconnect() {
+            boost::shared_ptr<detail::slot_list_base> p=_list.lock();
+            if(p) {
+                p->disconnect(_id);
+            }
+            _list.reset();
+        }
+
+        //! Returns true if this slot is still connected.
+        bool connected() const {
+            boost::shared_ptr<detail::slot_list_base> p=_list.lock();
+            return p && p->connected(_id);
+        }
+
+    protected:
+        boost::weak_ptr<detail::slot_list_base> _list; //!< Slot list of the bus.
+        std::size_t _id; //!< Identifier of the slot.
+    };
+
+    //! Connection that disconnects its slot when destroyed or reassigned.
+    class scoped_connection : public connection {
+    public:
+        //! Constructs an empty scoped connection.
+        scoped_connection() {
+        }
+
+        //! Takes ownership of connection c.
+        scoped_connection(const connection& c) : connection(c) {
+        }
+
+        //! Destructor; disconnects the slot.
+        ~scoped_connection() {
+            disconnect();
+        }
+
+        //! Disconnects the current slot, and takes ownership of connection c.
+        scoped_connection& operator=(const connection& c) {
+            disconnect();
+            connection::operator=(c);
+            return *this;
+        }
+
+    private:
+        scoped_connection(const scoped_connection&);
+        scoped_connection& operator=(const scoped_connection&);
+    };
+
+    namespace detail {
+
+        /*! Contiguous, ordered list of slots.
+
+         Slots are called through a plain function pointer (the "thunk") with
+         a pointer to the object that receives the event.  Slots connected or
+         disconnected while the list is being emitted are added or removed once
+         the outermost emission completes, so that emission can walk the
+         storage directly.
+         */
+        template <typename Thunk>
+        struct slot_list : slot_list_base {
+            //! A single slot.
+            struct slot {
+                Thunk f; //!< Thunk; null if disconnected during emission.
+                void* obj; //!< Object passed to the thunk.
+                boost::shared_ptr<void> holder; //!< Owns obj for function object slots.
+                std::size_t id; //!< Identifier of this slot.
+                int order; //!< Group of this slot, if grouped.
+                bool grouped; //!< Whether this slot is grouped.
+
+                //! Grouped slots are called in order of their group, before ungrouped slots.
+                bool operator<(const slot& that) const {
+                    return grouped && (!that.grouped || (order < that.order));
+                }
+            };
+
+            typedef std::vector<slot> slot_vector_type;
+
+            //! Constructor.
+            slot_list() : next_id(1), emitting(0), dirty(false) {
+            }
+
+            //! Connect a slot, returning its identifier.
+            std::size_t connect(Thunk f, void* obj, const boost::shared_ptr<void>& holder, bool grouped, int order) {
+                slot s;
+                s.f = f; s.obj = obj; s.holder = holder;
+                s.id = next_id++; s.order = order; s.grouped = grouped;
+                if(emitting) {
+                    pending.push_back(s);
+                    dirty = true;
+                } else {
+                    insert(s);
+                }
+                return s.id;
+            }
+
+            //! Disconnect the slot with the given identifier.
+            void disconnect(std::size_t id) {
+                typename slot_vector_type::iterator i=find(slots, id);
+                if(i != slots.end()) {
+                    if(emitting) {
+                        i->f = 0;
+                        dirty = true;
+                    } else {
+                        slots.erase(i);
+                    }
+                    return;
+                }
+                i = find(pending, id);
+                if(i != pending.end()) {
+                    pending.erase(i);
+                }
+            }
+
+            //! Returns true if the slot with the given identifier is connected.
+            bool connected(std::size_t id) const {
+                for(typename slot_vector_type::const_iterator i=slots.begin(); i!=slots.end(); ++i) {
+                    if(i->id == id) {
+                        return i->f != 0;
+                    }
+                }
+                for(typename slot_vector_type::const_iterator i=pending.begin(); i!=pending.end(); ++i) {
+                    if(i->id == id) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            //! Disconnect all slots.
+            void clear() {
+                if(emitting) {
+                    for(typename slot_vector_type::iterator i=slots.begin(); i!=slots.end(); ++i) {
+                        i->f = 0;
+                    }
+                    pending.clear();
+                    dirty = true;
+                } else {
+                    slots.clear();
+                    pending.clear();
+                }
+            }
+
+            //! Returns the number of connected slots.
+            std::size_t size() const {
+                std::size_t n=pending.size();
+                for(typename slot_vector_type::const_iterator i=slots.begin(); i!=slots.end(); ++i) {
+                    n += (i->f != 0);
+                }
+                return n;
+            }
+
+            //! Insert slot s after all slots that precede or are equivalent to it.
+            void insert(const slot& s) {
+                slots.insert(std::upper_bound(slots.begin(), slots.end(), s), s);
+            }
+
+            //! Returns an iterator to the slot with the given identifier.
+            static typename slot_vector_type::iterator find(slot_vector_type& v, std::size_t id) {
+                typename slot_vector_type::iterator i=v.begin();
+                for( ; (i!=v.end()) && (i->id != id); ++i) { }
+                return i;
+            }
+
+            //! Remove slots disconnected during emission, and add those connected.
+            void compact() {
+                std::size_t j=0;
+                for(std::size_t i=0; i<slots.size(); ++i) {
+                    if(slots[i].f != 0) {
+                        if(i != j) {
+                            slots[j] = slots[i];
+                        }
+                        ++j;
+                    }
+                }
+                slots.erase(slots.begin()+j, slots.end());
+                for(std::size_t i=0; i<pending.size(); ++i) {
+                    insert(pending[i]);
+                }
+                pending.clear();
+                dirty = false;
+            }
+
+            slot_vector_type slots; //!< Connected slots, in call order.
+            slot_vector_type pending; //!< Slots connected during emission.
+            std::size_t next_id; //!< Identifier of the next slot.
+            unsigned int emitting; //!< Depth of (possibly recursive) emissions.
+            bool dirty; //!< Whether slots changed during emission.
+        };
+
+        //! Marks a slot list as being emitted for the lifetime of this object.
+        template <typename SlotList>
+        struct emission_guard {
+            emission_guard(SlotList& l) : _l(l) {
+                ++_l.emitting;
+            }
+            ~emission_guard() {
+                if((--_l.emitting == 0) && _l.dirty) {
+                    _l.compact();
+                }
+            }
+            SlotList& _l;
+        };
+
+        /*! Common base for event buses: slot storage, connection, and
+         disconnection.
+         */
+        template <typename Thunk>
+        class event_bus_base : boost::noncopyable {
+        public:
+            typedef slot_list<Thunk> slot_list_type;
+            typedef typename slot_list_type::slot_vector_type slot_vector_type;
+
+            //! Constructor.
+            event_bus_base() : _impl(new slot_list_type()) {
+            }
+
+            //! Returns true if no slots are connected.
+            bool empty() const { return num_slots() == 0; }
+
+            //! Returns the number of connected slots.
+            std::size_t num_slots() const { return _impl->size(); }
+
+            //! Disconnect all slots.
+            void disconnect_all_slots() { _impl->clear(); }
+
+        protected:
+            //! Connect a slot.
+            connection connect_slot(Thunk f, void* obj, const boost::shared_ptr<void>& holder, bool grouped, int order) {
+                std::size_t id=_impl->connect(f, obj, holder, grouped, order);
+                return connection(_impl, id);
+            }
+
+            //! Connect a copy of function object g.
+            template <typename F, typename G>
+            connection connect_function(Thunk f, const G& g, bool grouped, int order) {
+                boost::shared_ptr<F> p(new F(g));
+                return connect_slot(f, p.get(), p, grouped, order);
+            }
+
+            boost::shared_ptr<slot_list_type> _impl; //!< Slots.
+        };
+
+    } // detail
+
+    /*! Unsynchronized event bus, an alternative to boost::signals2::signal.
+
+     Slots are either a member function bound at compile time to an object,
+     e.g., bus.connect<T, &T::f>(this), or a copy of a function object, e.g.,
+     bus.connect(boost::bind(...)).  Slots are stored contiguously, and
+     emission walks them calling each through a function pointer; if no slots
+     are connected, emission is a single branch.  As with signals2, slots
+     connected with an order are called in increasing order, followed by
+     slots connected without one, each in order of connection.
+
+     Unlike signals2, event buses take no locks, and so must not be connected
+     to, disconnected from, or emitted concurrently from different threads.
+
+     Event buses are provided for void signatures of one to four arguments.
+     */
+    template <typename Signature>
+    class event_bus;
+
+    //! Event bus for events with one argument.
+    template <typename A1>
+    class event_bus<void(A1)> : public detail::event_bus_base<void (*)(void*, A1)> {
+    public:
+        typedef void (*thunk_type)(void*, A1);
+        typedef detail::event_bus_base<thunk_type> parent;
+
+        template <typename T, void (T::*M)(A1)>
+        connection connect(T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), false, 0); }
+        template <typename T, void (T::*M)(A1)>
+        connection connect(int order, T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), true, order); }
+        template <typename F>
+        connection connect(const F& f) { return this->template connect_function<F>(&function<F>, f, false, 0); }
+        template <typename F>
+        connection connect(int order, const F& f) { return this->template connect_function<F>(&function<F>, f, true, order); }
+
+        //! Emit this event.
+        void operator()(A1 a1) {
+            if(this->_impl->slots.empty()) {
+                return;
+            }
+            detail::emission_guard<typename parent::slot_list_type> g(*this->_impl);
+            const typename parent::slot_vector_type& s=this->_impl->slots;
+            for(std::size_t i=0; i<s.size(); ++i) {
+                if(s[i].f) { s[i].f(s[i].obj, a1); }
+            }
+        }
+
+    private:
+        template <typename T, void (T::*M)(A1)>
+        static void member(void* p, A1 a1) { (static_cast<T*>(p)->*M)(a1); }
+        template <typename F>
+        static void function(void* p, A1 a1) { (*static_cast<F*>(p))(a1); }
+    };
+
+    //! Event bus for events with two arguments.
+    template <typename A1, typename A2>
+    class event_bus<void(A1,A2)> : public detail::event_bus_base<void (*)(void*, A1, A2)> {
+    public:
+        typedef void (*thunk_type)(void*, A1, A2);
+        typedef detail::event_bus_base<thunk_type> parent;
+
+        template <typename T, void (T::*M)(A1,A2)>
+        connection connect(T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), false, 0); }
+        template <typename T, void (T::*M)(A1,A2)>
+        connection connect(int order, T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), true, order); }
+        template <typename F>
+        connection connect(const F& f) { return this->template connect_function<F>(&function<F>, f, false, 0); }
+        template <typename F>
+        connection connect(int order, const F& f) { return this->template connect_function<F>(&function<F>, f, true, order); }
+
+        //! Emit this event.
+        void operator()(A1 a1, A2 a2) {
+            if(this->_impl->slots.empty()) {
+                return;
+            }
+            detail::emission_guard<typename parent::slot_list_type> g(*this->_impl);
+            const typename parent::slot_vector_type& s=this->_impl->slots;
+            for(std::size_t i=0; i<s.size(); ++i) {
+                if(s[i].f) { s[i].f(s[i].obj, a1, a2); }
+            }
+        }
+
+    private:
+        template <typename T, void (T::*M)(A1,A2)>
+        static void member(void* p, A1 a1, A2 a2) { (static_cast<T*>(p)->*M)(a1, a2); }
+        template <typename F>
+        static void function(void* p, A1 a1, A2 a2) { (*static_cast<F*>(p))(a1, a2); }
+    };
+
+    //! Event bus for events with three arguments.
+    template <typename A1, typename A2, typename A3>
+    class event_bus<void(A1,A2,A3)> : public detail::event_bus_base<void (*)(void*, A1, A2, A3)> {
+    public:
+        typedef void (*thunk_type)(void*, A1, A2, A3);
+        typedef detail::event_bus_base<thunk_type> parent;
+
+        template <typename T, void (T::*M)(A1,A2,A3)>
+        connection connect(T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), false, 0); }
+        template <typename T, void (T::*M)(A1,A2,A3)>
+        connection connect(int order, T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), true, order); }
+        template <typename F>
+        connection connect(const F& f) { return this->template connect_function<F>(&function<F>, f, false, 0); }
+        template <typename F>
+        connection connect(int order, const F& f) { return this->template connect_function<F>(&function<F>, f, true, order); }
+
+        //! Emit this event.
+        void operator()(A1 a1, A2 a2, A3 a3) {
+            if(this->_impl->slots.empty()) {
+                return;
+            }
+            detail::emission_guard<typename parent::slot_list_type> g(*this->_impl);
+            const typename parent::slot_vector_type& s=this->_impl->slots;
+            for(std::size_t i=0; i<s.size(); ++i) {
+                if(s[i].f) { s[i].f(s[i].obj, a1, a2, a3); }
+            }
+        }
+
+    private:
+        template <typename T, void (T::*M)(A1,A2,A3)>
+        static void member(void* p, A1 a1, A2 a2, A3 a3) { (static_cast<T*>(p)->*M)(a1, a2, a3); }
+        template <typename F>
+        static void function(void* p, A1 a1, A2 a2, A3 a3) { (*static_cast<F*>(p))(a1, a2, a3); }
+    };
+
+    //! Event bus for events with four arguments.
+    template <typename A1, typename A2, typename A3, typename A4>
+    class event_bus<void(A1,A2,A3,A4)> : public detail::event_bus_base<void (*)(void*, A1, A2, A3, A4)> {
+    public:
+        typedef void (*thunk_type)(void*, A1, A2, A3, A4);
+        typedef detail::event_bus_base<thunk_type> parent;
+
+        template <typename T, void (T::*M)(A1,A2,A3,A4)>
+        connection connect(T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), false, 0); }
+        template <typename T, void (T::*M)(A1,A2,A3,A4)>
+        connection connect(int order, T* obj) { return this->connect_slot(&member<T,M>, obj, boost::shared_ptr<void>(), true, order); }
+        template <typename F>
+        connection connect(const F& f) { return this->template connect_function<F>(&function<F>, f, false, 0); }
+        template <typename F>
+        connection connect(int order, const F& f) { return this->template connect_function<F>(&function<F>, f, true, order); }
+
+        //! Emit this event.
+        void operator()(A1 a1, A2 a2, A3 a3, A4 a4) {
+            if(this->_impl->slots.empty()) {
+                return;
+            }
+            detail::emission_guard<typename parent::slot_list_type> g(*this->_impl);
+            const typename parent::slot_vector_type& s=this->_impl->slots;
+            for(std::size_t i=0; i<s.size(); ++i) {
+                if(s[i].f) { s[i].f(s[i].obj, a1, a2, a3, a4); }
+            }
+        }
+
+    private:
+        template <typename T, void (T::*M)(A1,A2,A3,A4)>
+        static void member(void* p, A1 a1, A2 a2, A3 a3, A4 a4) { (static_cast<T*>(p)->*M)(a1, a2, a3, a4); }
+        template <typename F>
+        static void function(void* p, A1 a1, A2 a2, A3 a3, A4 a4) { (*static_cast<F*>(p))(a1, a2, a3, a4); }
+    };
+
+} // ealib
+
+#endif
@@ -21,12 +21,10 @@
 #define _EA_EVENTS_H_
 
 #include <boost/bind.hpp>
-//#ifndef BOOST_SIGNALS_NO_DEPRECATION_WARNING
-//#define BOOST_SIGNALS_NO_DEPRECATION_WARNING
-//#endif
-#include <boost/signals2.hpp>
+#include <boost/shared_ptr.hpp>
 #include <vector>
 
+#include <ea/event_bus.h>
 #include <ea/metadata.h>
 
 namespace ealib {
@@ -35,15 +33,16 @@ namespace ealib {
     struct event {
         virtual ~event() {
         }
-        boost::signals2::scoped_connection conn;
+        scoped_connection conn;
     };
     
     /*! Contains event handlers for generic events of interest within an evolutionary
 	 algorithm.
 	 
      An easy way to attach to any of these events is by subclassing the *_event structs
-     below.  Because they use a boost::bind expression to connect to the signals, we
-     avoid any difficulty with copy construction of the slots.
+     below.  They connect their (virtual) member functions to the event buses
+     directly, so firing an event costs a call through a function pointer per
+     listener, and a single branch if there are none.
 	 */
 	template <typename EA>
 	class event_handler {
@@ -55,27 +54,27 @@ namespace ealib {
         }
         
         // Called after the fitness of an individual has been evaluated.
-        boost::signals2::signal<void(typename EA::individual_type&, // individual
+        event_bus<void(typename EA::individual_type&, // individual
                                      EA&)> fitness_evaluated;
         
 		//! Called at the end of every update.
-		boost::signals2::signal<void(EA&)> end_of_update;
+		event_bus<void(EA&)> end_of_update;
 		
 		//! Called after every epoch.
-		boost::signals2::signal<void(EA&)> end_of_epoch;
+		event_bus<void(EA&)> end_of_epoch;
 		
 		//! Called when an offspring individual inherits from its parents.
-		boost::signals2::signal<void(typename EA::population_type&, // parents
+		event_bus<void(typename EA::population_type&, // parents
                                      typename EA::individual_type&, // offspring
                                      EA&)> inheritance;
         
         //! Called when an individual asexually replicates.
-		boost::signals2::signal<void(typename EA::individual_type&, // parent
+		event_bus<void(typename EA::individual_type&, // parent
                                      typename EA::individual_type&, // offspring
                                      EA&)> replication;
         
         //! Called at the beginning of epochs and at the end of every generation.
-		boost::signals2::signal<void(EA&)> record_statistics;
+		event_bus<void(EA&)> record_statistics;
         
         //! Add a slot (event handler) to the events for this EA.
         template <template <typename> class Event>
@@ -103,7 +102,7 @@ namespace ealib {
     template <typename EA>
     struct fitness_evaluated_event : event {
         fitness_evaluated_event(EA& ea) {
-            conn = ea.events().fitness_evaluated.connect(boost::bind(&fitness_evaluated_event::operator(), this, _1, _2));
+            conn = ea.events().fitness_evaluated.template connect<fitness_evaluated_event, &fitness_evaluated_event::operator()>(this);
         }
         virtual ~fitness_evaluated_event() { }
         virtual void operator()(typename EA::individual_type& ind, EA& ea) = 0;
@@ -112,10 +111,10 @@ namespace ealib {
     template <typename EA>
     struct end_of_update_event : event {
         end_of_update_event(int order, EA& ea) {
-            conn = ea.events().end_of_update.connect(order, boost::bind(&end_of_update_event::operator(), this, _1));
+            conn = ea.events().end_of_update.template connect<end_of_update_event, &end_of_update_event::operator()>(order, this);
         }
         end_of_update_event(EA& ea) {
-            conn = ea.events().end_of_update.connect(boost::bind(&end_of_update_event::operator(), this, _1));
+            conn = ea.events().end_of_update.template connect<end_of_update_event, &end_of_update_event::operator()>(this);
         }
         virtual ~end_of_update_event() { }
         virtual void operator()(EA& ea) = 0;
@@ -124,10 +123,10 @@ namespace ealib {
     template <typename MDType, typename EA>
     struct periodic_event : event {
         periodic_event(int order, EA& ea) : _n(0) {
-            conn = ea.events().end_of_update.connect(order, boost::bind(&periodic_event::end_of_update, this, _1));
+            conn = ea.events().end_of_update.template connect<periodic_event, &periodic_event::end_of_update>(order, this);
         }
         periodic_event(EA& ea) : _n(0) {
-            conn = ea.events().end_of_update.connect(boost::bind(&periodic_event::end_of_update, this, _1));
+            conn = ea.events().end_of_update.template connect<periodic_event, &periodic_event::end_of_update>(this);
         }
         virtual ~periodic_event() { }
         
@@ -148,7 +147,7 @@ namespace ealib {
     template <typename EA>
     struct end_of_epoch_event : event {
         end_of_epoch_event(EA& ea) {
-            conn = ea.events().end_of_epoch.connect(boost::bind(&end_of_epoch_event::operator(), this, _1));
+            conn = ea.events().end_of_epoch.template connect<end_of_epoch_event, &end_of_epoch_event::operator()>(this);
         }
         virtual ~end_of_epoch_event() { }
         virtual void operator()(EA& ea) = 0;
@@ -157,7 +156,7 @@ namespace ealib {
     template <typename EA>
     struct record_statistics_event : event {
         record_statistics_event(EA& ea) {
-            conn = ea.events().record_statistics.connect(boost::bind(&record_statistics_event::record, this, _1));
+            conn = ea.events().record_statistics.template connect<record_statistics_event, &record_statistics_event::record>(this);
         }
         virtual ~record_statistics_event() { }
         virtual void record(EA& ea) {
@@ -172,7 +171,7 @@ namespace ealib {
     template <typename EA>
     struct inheritance_event : event {
         inheritance_event(EA& ea) {
-            conn = ea.events().inheritance.connect(boost::bind(&inheritance_event::operator(), this, _1, _2, _3));
+            conn = ea.events().inheritance.template connect<inheritance_event, &inheritance_event::operator()>(this);
         }
         virtual ~inheritance_event() { }
         virtual void operator()(typename EA::population_type&, // parents
@@ -183,7 +182,7 @@ namespace ealib {
     template <typename EA>
     struct replication_event : event {
         replication_event(EA& ea) {
-            conn = ea.events().replication.connect(boost::bind(&replication_event::operator(), this, _1, _2, _3));
+            conn = ea.events().replication.template connect<replication_event, &replication_event::operator()>(this);
         }
         virtual ~replication_event() { }
         virtual void operator()(typename EA::individual_type&, // parent
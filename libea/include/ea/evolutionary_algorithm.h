@@ -30,9 +30,11 @@
 #include <ea/data_structures/shared_ptr_vector.h>
 #include <ea/events.h>
 #include <ea/individual.h>
+#include <ea/individual_id.h>
 #include <ea/lifecycle.h>
 #include <ea/metadata.h>
 #include <ea/mutation.h>
+#include <ea/pooled_individual.h>
 #include <ea/population_structure.h>
 #include <ea/selection.h>
 #include <ea/recombination.h>
@@ -49,6 +51,10 @@ namespace ealib {
      evolutionary algorithms can be incorporated.  The focus of this class is on
      the common features of most EAs, while leaving the problem-specific
      components easily customizable.
+     
+     Individuals are held by boost::shared_ptr by default; selecting
+     pooled_individualS for IndividualStorage instead draws them from a memory
+     pool and reference counts them intrusively (see pooled_individual.h).
 	 
      \warning See note below regarding copy construction.
      */
@@ -63,6 +69,7 @@ namespace ealib {
     , typename PopulationGenerator=fill_population
     , typename Lifecycle=default_lifecycle
     , template <typename> class IndividualTraits=fitness_trait
+    , typename IndividualStorage=shared_individualS
     > class evolutionary_algorithm {
     public:
         typedef singlePopulationS population_structure_tag;
@@ -80,8 +87,9 @@ namespace ealib {
         typedef PopulationGenerator population_generator_type;
         typedef Lifecycle lifecycle_type;
         typedef IndividualTraits<evolutionary_algorithm> individual_traits_type;
-        typedef individual<representation_type, individual_traits_type> individual_type;
-        typedef boost::shared_ptr<individual_type> individual_ptr_type;
+        typedef individual_storage<individual<representation_type, individual_traits_type>, IndividualStorage> individual_storage_type;
+        typedef typename individual_storage_type::individual_type individual_type;
+        typedef typename individual_storage_type::pointer_type individual_ptr_type;
         typedef metadata md_type;
         typedef default_rng_type rng_type;
         typedef event_handler<evolutionary_algorithm> event_handler_type;
@@ -95,11 +103,13 @@ namespace ealib {
         class state_type {
         public:
             //! Default constructor.
-            state_type() : update(0) {
+            state_type() : update(0), next_id(first_individual_id(0)), id_stream(0) {
             }
             
             // assignable:
             unsigned long update; //!< Update number for this EA.
+            individual_id_type next_id; //!< Identifier of the next individual born in this EA.
+            individual_id_type id_stream; //!< Id stream from which identifiers are taken.
             rng_type rng; //!< Random number generator.
             md_type md; //!< Meta-data for this evolutionary algorithm instance.
             fitness_function_type fitness_function; //!< Fitness function object.
@@ -122,7 +132,7 @@ namespace ealib {
             void serialize(Archive & ar, const unsigned int version) {
                 ar & BOOST_SERIALIZATION_NVP(update);
                 ar & BOOST_SERIALIZATION_NVP(rng);
-                ar & BOOST_SERIALIZATION_NVP(md);
+                detail::serialize_ea_md(ar, "md", next_id, id_stream, md);
                 ar & BOOST_SERIALIZATION_NVP(population);
             }
         };
@@ -173,6 +183,8 @@ namespace ealib {
                     // events, isa, etc).  copy the easy parts of state first:
                     _state->update = that._state->update;
                     _state->rng = that._state->rng;
+                    _state->next_id = that._state->next_id;
+                    _state->id_stream = that._state->id_stream;
                     _state->md = that._state->md;
                     _state->fitness_function = that._state->fitness_function;
                     _state->stop = that._state->stop;
@@ -205,7 +217,8 @@ namespace ealib {
                 _state->md = md;
                 
                 if(exists<RNG_SEED>(*this)) {
-                    _state->rng.reset(get<RNG_SEED>(*this));
+                    // a seed of 0 seeds from the clock; save the seed that was used:
+                    put<RNG_SEED>(_state->rng.reset(get<RNG_SEED>(*this)), *this);
                 } else {
                     unsigned int s = _state->rng.seed();
                     _state->rng.reset(s);
@@ -252,8 +265,7 @@ namespace ealib {
 
         //! Resets this EA's RNG seed.
         void reset_rng(unsigned int s) {
-            put<RNG_SEED>(s,*this); // save the seed!
-            _state->rng.reset(s);
+            put<RNG_SEED>(_state->rng.reset(s), *this); // save the seed!
         }
 		
 		//! Returns true if this instance of digital_evolution has state.
@@ -261,6 +273,15 @@ namespace ealib {
             return _state != 0;
         }
         
+        //! Returns the identifier for the next individual born in this EA.
+        individual_id_type next_individual_id() { return take_individual_id(_state->next_id, _state->id_stream); }
+        
+        //! Restart this EA's individual identifiers in the given id stream.
+        void reset_individual_ids(individual_id_type stream) {
+            _state->id_stream = stream;
+            _state->next_id = first_individual_id(stream);
+        }
+        
         //! Returns the current update of this EA.
         unsigned long current_update() { return _state->update; }
         
@@ -31,12 +31,18 @@
 #include <ea/concepts.h>
 #include <ea/metadata.h>
 #include <ea/events.h>
+#include <ea/rng.h>
+#include <ea/thread_pool.h>
 
 namespace ealib {
 
     LIBEA_MD_DECL(FF_RNG_SEED, "ea.fitness_function.rng_seed", int);
     LIBEA_MD_DECL(FF_INITIAL_RNG_SEED, "ea.fitness_function.initial_rng_seed", int);
     LIBEA_MD_DECL(FF_INITIALIZATION_PERIOD, "ea.fitness_function.initialization_period", int);
+    LIBEA_MD_DECL(FF_THREADS, "ea.fitness_function.threads", unsigned int);
+    
+    //! Purpose of the rng streams from which stochastic fitness functions are seeded (see rng_stream).
+    const unsigned int FF_RNG_STREAM=1;
     
     /* The following are tags that are to be used to indicate properties of a
      given fitness function:
@@ -400,11 +406,23 @@ namespace ealib {
             ea.events().fitness_evaluated(i,ea);
         }
         
+        /*! Returns the seed of the RNG used to evaluate individual i during the
+         current update.
+         
+         Seeds are drawn from i's rng stream rather than from the EA's RNG, so
+         they do not depend on the order in which individuals are evaluated, or
+         on the number of threads evaluating them.
+         */
+        template <typename EA>
+        int fitness_seed(typename EA::individual_type& i, EA& ea) {
+            return rng_stream(i.id(), FF_RNG_STREAM, ea).seed();
+        }
+        
         //! Stochastic: provide an RNG for use during fitness evaluation.
         template <typename EA>
         void calculate_fitness(typename EA::individual_type& i, stochasticS, EA& ea) {
 			initialize_fitness_function(ea);
-			int seed = ea.rng().seed();
+			int seed = fitness_seed(i, ea);
             typename EA::rng_type rng(seed);
             put<FF_RNG_SEED>(seed, i); // save the seed that was used to evaluate this individual
             i.traits().fitness() = ea.fitness_function()(i, rng, ea);
@@ -432,9 +450,135 @@ namespace ealib {
         detail::calculate_fitness(ind, typename EA::fitness_function_type::constant_tag(), ea);
     }
     
-    //! Calculate fitness for the range [f,l).
+    namespace detail {
+        //! Returns true if this individual's fitness would be calculated (constant).
+        template <typename EA>
+        bool needs_fitness(typename EA::individual_type& i, constantS, EA& ea) {
+            return i.traits().fitness().is_null();
+        }
+        
+        //! Returns true if this individual's fitness would be calculated (nonstationary).
+        template <typename EA>
+        bool needs_fitness(typename EA::individual_type& i, nonstationaryS, EA& ea) {
+            return true;
+        }
+        
+        //! Task that evaluates the fitness of the j'th individual selected for evaluation.
+        template <typename EA>
+        struct fitness_task {
+            typedef typename EA::individual_type individual_type;
+            
+            fitness_task(std::vector<individual_type*>& inds, std::vector<int>& seeds, EA& ea)
+            : _inds(inds), _seeds(seeds), _ea(ea) {
+            }
+            
+            void operator()(std::size_t j) {
+                eval(*_inds[j], j, typename EA::fitness_function_type::stability_tag());
+            }
+            
+            void eval(individual_type& i, std::size_t j, deterministicS) {
+                i.traits().fitness() = _ea.fitness_function()(i, _ea);
+            }
+            
+            void eval(individual_type& i, std::size_t j, stochasticS) {
+                typename EA::rng_type rng(_seeds[j]);
+                i.traits().fitness() = _ea.fitness_function()(i, rng, _ea);
+            }
+            
+            std::vector<individual_type*>& _inds;
+            std::vector<int>& _seeds;
+            EA& _ea;
+        };
+
+        //! Draw seeds for individuals to be evaluated (deterministic; no-op).
+        template <typename EA>
+        void draw_fitness_seeds(std::vector<typename EA::individual_type*>& inds, std::vector<int>& seeds, deterministicS, EA& ea) {
+        }
+        
+        //! Draw seeds for individuals to be evaluated (stochastic).
+        template <typename EA>
+        void draw_fitness_seeds(std::vector<typename EA::individual_type*>& inds, std::vector<int>& seeds, stochasticS, EA& ea) {
+            seeds.resize(inds.size());
+            for(std::size_t j=0; j<inds.size(); ++j) {
+                seeds[j] = fitness_seed(*inds[j], ea);
+                put<FF_RNG_SEED>(seeds[j], *inds[j]);
+            }
+        }
+        
+        //! Makes an EA's meta-data concurrent (see metadata::concurrent) for the lifetime of this object.
+        template <typename EA>
+        struct concurrent_md_guard {
+            concurrent_md_guard(EA& ea) : _md(ea.md()), _set(!_md.concurrent()) {
+                if(_set) {
+                    _md.concurrent(true);
+                }
+            }
+            
+            ~concurrent_md_guard() {
+                if(_set) {
+                    _md.concurrent(false);
+                }
+            }
+            
+            metadata& _md; //!< Meta-data made concurrent.
+            bool _set; //!< Whether this guard made the meta-data concurrent.
+        };
+        
+        /*! Calculate fitness for the range [f,l) using up to n threads.
+         
+         This proceeds in three phases: First, on the calling thread, the
+         individuals that require evaluation are identified and (for stochastic
+         fitness functions) their RNG seeds are drawn from their rng streams (see
+         fitness_seed).  Second, fitness is calculated for those individuals in
+         parallel, while the EA's meta-data is concurrent.  Third,
+         fitness_evaluated events are triggered on the calling thread, in range
+         order.  Results are thus identical regardless of the number of threads.
+         */
+        template <typename ForwardIterator, typename EA>
+        void parallel_calculate_fitness(ForwardIterator f, ForwardIterator l, std::size_t n, EA& ea) {
+            typedef typename EA::individual_type individual_type;
+            typedef typename EA::fitness_function_type::stability_tag stability_tag;
+            
+            std::vector<individual_type*> inds;
+            for(; f!=l; ++f) {
+                if(needs_fitness(*f, typename EA::fitness_function_type::constant_tag(), ea)) {
+                    inds.push_back(&(*f));
+                }
+            }
+            if(inds.empty()) {
+                return;
+            }
+            
+            initialize_fitness_function(ea);
+            std::vector<int> seeds;
+            draw_fitness_seeds(inds, seeds, stability_tag(), ea);
+            
+            {
+                concurrent_md_guard<EA> g(ea);
+                parallel_for(inds.size(), fitness_task<EA>(inds, seeds, ea), n);
+            }
+            
+            for(std::size_t j=0; j<inds.size(); ++j) {
+                ea.events().fitness_evaluated(*inds[j], ea);
+            }
+        }
+    } // detail
+    
+    /*! Calculate fitness for the range [f,l).
+     
+     If FF_THREADS is greater than one, fitness evaluations are spread across
+     that many threads (see detail::parallel_calculate_fitness); in this case,
+     the fitness function must be safe to call concurrently, and must not write
+     the EA's meta-data, which is concurrent while fitness is calculated (see
+     metadata::concurrent).
+     */
 	template <typename ForwardIterator, typename EA>
 	void calculate_fitness(ForwardIterator f, ForwardIterator l, EA& ea) {
+        std::size_t n = get<FF_THREADS>(ea,1);
+        if(n > 1) {
+            detail::parallel_calculate_fitness(f, l, n, ea);
+            return;
+        }
 		for(; f!=l; ++f) {
 			calculate_fitness(*f,ea);
 		}
@@ -25,6 +25,16 @@
 
 namespace ealib {
 	
+    /*! Returns the number of ones in the given sequence.
+     
+     Genome types with a packed representation (e.g., packed_bitstring) overload
+     this with a popcount.
+     */
+    template <typename Sequence>
+    std::size_t count_ones(const Sequence& s) {
+        return std::count(s.begin(), s.end(), 1u);
+    }
+    
 	/*! Fitness function that rewards for the number of ones in the genome.
 	 
      (Primarily for testing.)
@@ -32,7 +42,7 @@ namespace ealib {
 	struct all_ones : public fitness_function<unary_fitness<double> > {
 		template <typename Individual, typename EA>
 		double operator()(Individual& ind, EA& ea) {
-			return static_cast<double>(std::count(ind.genome().begin(), ind.genome().end(), 1u))
+			return static_cast<double>(count_ones(ind.genome()))
             / static_cast<double>(ind.genome().size());
 		}
 	};
@@ -20,23 +20,59 @@
 #ifndef _EA_GENERATIONAL_MODELS_ISOLATED_SUBPOPULATIONS_H_
 #define _EA_GENERATIONAL_MODELS_ISOLATED_SUBPOPULATIONS_H_
 
+#include <ea/metadata.h>
+#include <ea/thread_pool.h>
+
 namespace ealib {
+    LIBEA_MD_DECL(METAPOPULATION_THREADS, "ea.metapopulation.threads", unsigned int);
+    
 	namespace generational_models {
         
+        namespace detail {
+            //! Task that updates the i'th subpopulation.
+            template <typename Population>
+            struct update_subpopulation {
+                update_subpopulation(Population& population) : _population(population) {
+                }
+                
+                void operator()(std::size_t i) {
+                    _population[i]->update();
+                }
+                
+                Population& _population;
+            };
+        } // detail
+        
         /*! Default generational model for a metapopulation EA, where all
          EAs are updated in lock-step, and do not themselves engage in
          a subpopulation-level evolutionary process.
          
          Coupled with a migration event, this generational model provides an
          island model.
+         
+         If METAPOPULATION_THREADS is greater than one, subpopulations are
+         updated concurrently on that many threads.  Since each subpopulation
+         has its own RNG, population, and meta-data, results are identical to
+         those of sequential updates.  All subpopulation updates complete before
+         this method returns, and thus before any cross-subpopulation step
+         (e.g., migration, competition) is performed.
+         
+         Events attached to subpopulations are triggered on the thread that
+         updates that subpopulation, so they must not share state with one
+         another.  In particular, meta-level listeners that attach to every
+         subpopulation, or read other subpopulations, are incompatible with more
+         than one thread (e.g., datafiles::meta_population_fitness_evaluations,
+         which throws in that case); attach such listeners to the
+         metapopulation's own events (e.g., end_of_update) instead, which are
+         triggered after all subpopulations have been updated.
          */
         struct isolated_subpopulations {
             //! Apply this generational model to the metapopulation.
             template <typename Population, typename EA>
             void operator()(Population& population, EA& ea) {
-                for(typename Population::iterator i=population.begin(); i!=population.end(); ++i) {
-                    (*i)->update();
-                }
+                parallel_for(population.size(),
+                             detail::update_subpopulation<Population>(population),
+                             get<METAPOPULATION_THREADS>(ea,1));
             }
         };
         
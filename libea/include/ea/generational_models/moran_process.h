@@ -20,6 +20,7 @@
 #ifndef _EA_GENERATIONAL_MODELS_MORAN_PROCESS_H_
 #define _EA_GENERATIONAL_MODELS_MORAN_PROCESS_H_
 
+#include <boost/iterator/indirect_iterator.hpp>
 #include <ea/metadata.h>
 #include <ea/selection/proportionate.h>
 #include <ea/selection/random.h>
@@ -52,6 +53,14 @@ namespace ealib {
 			//! Apply this generational model to the EA to produce a single new generation.
 			template <typename Population, typename EA>
 			void operator()(Population& population, EA& ea) {
+                // if fitness is evaluated in parallel, calculate fitness of the
+                // current population up front; otherwise, it is calculated lazily
+                // during selection, as before:
+                if(get<FF_THREADS>(ea,1) > 1) {
+                    calculate_fitness(boost::make_indirect_iterator(population.begin()),
+                                      boost::make_indirect_iterator(population.end()), ea);
+                }
+                
                 // how many survivors?
                 std::size_t n = static_cast<std::size_t>((1.0 - get<MORAN_REPLACEMENT_RATE_P>(ea)) * get<POPULATION_SIZE>(ea));
                 
@@ -0,0 +1,349 @@
+/* chunked_genome.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_GENOME_TYPES_CHUNKED_GENOME_H_
+#define _EA_GENOME_TYPES_CHUNKED_GENOME_H_
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <ea/metadata.h>
+
+namespace ealib {
+    
+    /*! Genome with chunked, copy-on-write storage.
+     
+     chunked_genome is a drop-in replacement for numeric_vector: it provides a
+     random-access container interface whose elements can be read, assigned,
+     and updated through a proxy reference, so existing ancestors, site
+     mutations, recombination operators, and fitness functions work unchanged.
+     
+     Sites are stored in fixed-size chunks of ChunkSize sites that are shared
+     among copies of a genome.  Copying a genome thus copies only a pointer per
+     chunk, and a chunk is copied only when one of its sites is written through
+     a genome that shares it.  Reading sites, even through non-const iterators,
+     never copies storage.  Offspring creation (e.g., via recombination::asexual
+     followed by mutation::operators::geometric_per_site) is therefore
+     proportional to the number of mutations rather than genome length, and
+     related genomes share memory.
+     
+     Inserting or erasing sites rebuilds the genome's storage, and so is linear
+     in genome length.
+     */
+    template <typename T, std::size_t ChunkSize=1024>
+    class chunked_genome {
+    public:
+        //! Type of this representation.
+        typedef chunked_genome representation_type;
+        //! Type of codon in this genome.
+        typedef T codon_type;
+        typedef T value_type;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        
+        //! Number of sites per chunk.
+        enum { chunk_size=ChunkSize };
+        
+        //! Storage for a single chunk.
+        struct chunk_type {
+            T data[ChunkSize];
+        };
+        
+        typedef boost::shared_ptr<chunk_type> chunk_ptr_type;
+        
+        //! Proxy reference to a single site, which copies its chunk only when written.
+        class reference {
+        public:
+            reference(chunked_genome* g, std::size_t i) : _g(g), _i(i) {
+            }
+            
+            operator const T&() const { return _g->at(_i); }
+            
+            reference& operator=(const T& v) { _g->mutable_at(_i) = v; return *this; }
+            reference& operator=(const reference& that) { return operator=(static_cast<const T&>(that)); }
+            reference& operator+=(const T& v) { _g->mutable_at(_i) += v; return *this; }
+            reference& operator-=(const T& v) { _g->mutable_at(_i) -= v; return *this; }
+            reference& operator*=(const T& v) { _g->mutable_at(_i) *= v; return *this; }
+            reference& operator^=(const T& v) { _g->mutable_at(_i) ^= v; return *this; }
+            
+            //! Swap the sites referred to by a and b (used by std::swap_ranges).
+            friend void swap(reference a, reference b) {
+                T t=a; a = static_cast<const T&>(b); b = t;
+            }
+            
+        protected:
+            chunked_genome* _g; //!< Genome containing this site.
+            std::size_t _i; //!< Index of this site.
+        };
+        
+        //! Iterator over sites.
+        class iterator : public boost::iterator_facade<iterator, T, std::random_access_iterator_tag, reference> {
+        public:
+            iterator() : _g(0), _i(0) { }
+            iterator(chunked_genome* g, std::size_t i) : _g(g), _i(i) { }
+        protected:
+            friend class boost::iterator_core_access;
+            friend class chunked_genome;
+            reference dereference() const { return reference(_g, _i); }
+            bool equal(const iterator& that) const { return _i == that._i; }
+            void increment() { ++_i; }
+            void decrement() { --_i; }
+            void advance(difference_type n) { _i += n; }
+            difference_type distance_to(const iterator& that) const {
+                return static_cast<difference_type>(that._i) - static_cast<difference_type>(_i);
+            }
+            chunked_genome* _g; //!< Genome being iterated over.
+            std::size_t _i; //!< Site index.
+        };
+        
+        //! Const iterator over sites.
+        class const_iterator : public boost::iterator_facade<const_iterator, const T, std::random_access_iterator_tag> {
+        public:
+            const_iterator() : _g(0), _i(0) { }
+            const_iterator(const chunked_genome* g, std::size_t i) : _g(g), _i(i) { }
+            const_iterator(const iterator& that) : _g(that._g), _i(that._i) { }
+        protected:
+            friend class boost::iterator_core_access;
+            const T& dereference() const { return _g->at(_i); }
+            bool equal(const const_iterator& that) const { return _i == that._i; }
+            void increment() { ++_i; }
+            void decrement() { --_i; }
+            void advance(difference_type n) { _i += n; }
+            difference_type distance_to(const const_iterator& that) const {
+                return static_cast<difference_type>(that._i) - static_cast<difference_type>(_i);
+            }
+            const chunked_genome* _g; //!< Genome being iterated over.
+            std::size_t _i; //!< Site index.
+        };
+        
+        typedef std::reverse_iterator<iterator> reverse_iterator;
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+        
+        //! Constructor.
+        chunked_genome() : _size(0) {
+        }
+        
+        //! Constructor that initializes to n sites of value v.
+        explicit chunked_genome(std::size_t n, const T& v=T()) : _size(0) {
+            resize(n, v);
+        }
+        
+        //! Constructor from a range of sites.
+        template <typename InputIterator>
+        chunked_genome(InputIterator f, InputIterator l,
+                       typename boost::disable_if<boost::is_integral<InputIterator> >::type* =0) : _size(0) {
+            for( ; f!=l; ++f) {
+                push_back(*f);
+            }
+        }
+        
+        //! Returns the number of sites.
+        std::size_t size() const { return _size; }
+        
+        //! Returns true if there are no sites.
+        bool empty() const { return _size == 0; }
+        
+        //! Remove all sites.
+        void clear() { _chunks.clear(); _size = 0; }
+        
+        //! Reserve storage for n sites.
+        void reserve(std::size_t n) { _chunks.reserve(nchunks(n)); }
+        
+        //! Resize to n sites; new sites are set to v.
+        void resize(std::size_t n, const T& v=T()) {
+            if(n > _size) {
+                // fill the remainder of the last chunk, then add new chunks:
+                std::size_t r=_size % ChunkSize;
+                if(r != 0) {
+                    chunk_type& c=mutable_chunk(_chunks.size()-1);
+                    std::fill(c.data+r, c.data+std::min(static_cast<std::size_t>(ChunkSize), r+(n-_size)), v);
+                }
+                while(_chunks.size() < nchunks(n)) {
+                    chunk_ptr_type c=boost::make_shared<chunk_type>();
+                    std::fill(c->data, c->data+ChunkSize, v);
+                    _chunks.push_back(c);
+                }
+            } else {
+                _chunks.resize(nchunks(n));
+            }
+            _size = n;
+        }
+        
+        //! Append a site.
+        void push_back(const T& v) {
+            if((_size % ChunkSize) == 0) {
+                _chunks.push_back(boost::make_shared<chunk_type>());
+            }
+            ++_size;
+            mutable_at(_size-1) = v;
+        }
+        
+        //! Insert the sites in [f,l) before pos.
+        template <typename InputIterator>
+        void insert(iterator pos, InputIterator f, InputIterator l) {
+            const chunked_genome& self=*this;
+            std::vector<T> v(self.begin(), self.end());
+            v.insert(v.begin()+pos._i, f, l);
+            assign(v.begin(), v.end());
+        }
+        
+        //! Insert site t before pos.
+        void insert(iterator pos, const T& t) {
+            insert(pos, &t, &t+1);
+        }
+        
+        //! Erase the sites in [f,l).
+        void erase(iterator f, iterator l) {
+            const chunked_genome& self=*this;
+            std::vector<T> v(self.begin(), self.end());
+            v.erase(v.begin()+f._i, v.begin()+l._i);
+            assign(v.begin(), v.end());
+        }
+        
+        //! Erase the site at pos.
+        void erase(iterator pos) {
+            erase(pos, pos+1);
+        }
+        
+        //! Replace the contents of this genome with [f,l).
+        template <typename InputIterator>
+        void assign(InputIterator f, InputIterator l) {
+            clear();
+            for( ; f!=l; ++f) {
+                push_back(*f);
+            }
+        }
+        
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, _size); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, _size); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+        
+        reference operator[](std::size_t i) { return reference(this, i); }
+        const T& operator[](std::size_t i) const { return at(i); }
+        
+        reference front() { return reference(this, 0); }
+        const T& front() const { return at(0); }
+        reference back() { return reference(this, _size-1); }
+        const T& back() const { return at(_size-1); }
+        
+        //! Returns site i, without copying storage.
+        const T& at(std::size_t i) const {
+            return _chunks[i/ChunkSize]->data[i%ChunkSize];
+        }
+        
+        //! Returns a mutable reference to site i, copying its chunk if it is shared.
+        T& mutable_at(std::size_t i) {
+            return mutable_chunk(i/ChunkSize).data[i%ChunkSize];
+        }
+        
+        //! Returns the number of chunks.
+        std::size_t num_chunks() const { return _chunks.size(); }
+        
+        //! Returns a const pointer to the storage of chunk c.
+        const T* chunk_data(std::size_t c) const { return _chunks[c]->data; }
+        
+        bool operator==(const chunked_genome& that) const {
+            if(_size != that._size) {
+                return false;
+            }
+            for(std::size_t c=0; c<_chunks.size(); ++c) {
+                if(_chunks[c] != that._chunks[c]) {
+                    std::size_t n=std::min(static_cast<std::size_t>(ChunkSize), _size - c*ChunkSize);
+                    if(!std::equal(_chunks[c]->data, _chunks[c]->data+n, that._chunks[c]->data)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        
+        bool operator!=(const chunked_genome& that) const {
+            return !operator==(that);
+        }
+        
+        bool operator<(const chunked_genome& that) const {
+            return std::lexicographical_compare(begin(), end(), that.begin(), that.end());
+        }
+        
+        //! Returns the number of chunks needed to store n sites.
+        static std::size_t nchunks(std::size_t n) {
+            return (n + ChunkSize - 1) / ChunkSize;
+        }
+        
+        // These enable a more compact serialization of the genome, and are
+        // compatible with numeric_vector.
+		template<class Archive>
+		void save(Archive & ar, const unsigned int version) const {
+			std::ostringstream out;
+			out << _size;
+			for(const_iterator i=begin(); i!=end(); ++i) {
+				out << " " << *i;
+			}
+			std::string genome(out.str());
+			ar & BOOST_SERIALIZATION_NVP(genome);
+		}
+		
+		template<class Archive>
+		void load(Archive & ar, const unsigned int version) {
+			std::string genome;
+			ar & BOOST_SERIALIZATION_NVP(genome);
+			std::istringstream in(genome);
+			std::size_t s;
+			in >> s;
+            clear();
+			reserve(s);
+			T t;
+			for( ; s>0; --s) {
+				in >> t;
+                push_back(t);
+			}
+		}
+		BOOST_SERIALIZATION_SPLIT_MEMBER();
+        
+    protected:
+        //! Returns chunk c, copying it first if it is shared.
+        chunk_type& mutable_chunk(std::size_t c) {
+            chunk_ptr_type& p=_chunks[c];
+            if(!p.unique()) {
+                p = boost::make_shared<chunk_type>(*p);
+            }
+            return *p;
+        }
+        
+        std::vector<chunk_ptr_type> _chunks; //!< Storage.
+        std::size_t _size; //!< Number of sites.
+    };
+    
+} // ea
+
+#endif
@@ -0,0 +1,404 @@
+/* packed_bitstring.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_GENOME_TYPES_PACKED_BITSTRING_H_
+#define _EA_GENOME_TYPES_PACKED_BITSTRING_H_
+
+#include <boost/cstdint.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <ea/metadata.h>
+#include <ea/mutation.h>
+
+namespace ealib {
+
+    //! Returns the number of set bits in x.
+    inline std::size_t popcount(boost::uint64_t x) {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_popcountll(x));
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return static_cast<std::size_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+
+    /*! Bitstring representation that packs 64 sites into each machine word.
+
+     packed_bitstring is a drop-in replacement for bitstring: it provides a
+     random-access container interface whose elements read as 0 or 1 and can
+     be assigned and xor'ed through a proxy reference, so existing ancestors,
+     site mutations, and fitness functions work unchanged.  In addition, it
+     exposes word-level operations (count, get, set, flip) that operators
+     specialized for this type use to avoid touching each site individually.
+
+     Site i is stored in bit i%64 of word i/64.  Bits past size() in the last
+     word are always zero.
+     */
+    class packed_bitstring {
+    public:
+        //! Type of this representation.
+        typedef packed_bitstring representation_type;
+        //! Type of the words used for storage.
+        typedef boost::uint64_t word_type;
+        //! Type of codon in this genome.
+        typedef int codon_type;
+        typedef int value_type;
+        typedef int const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        //! Number of bits per word.
+        enum { word_bits=64 };
+
+        //! Proxy reference to a single site.
+        class reference {
+        public:
+            reference(word_type* w, word_type m) : _w(w), _m(m) {
+            }
+
+            operator int() const { return (*_w & _m) ? 1 : 0; }
+
+            reference& operator=(int v) {
+                if(v) { *_w |= _m; } else { *_w &= ~_m; }
+                return *this;
+            }
+
+            reference& operator=(const reference& that) {
+                return operator=(static_cast<int>(that));
+            }
+
+            reference& operator^=(int v) {
+                if(v & 0x01) { *_w ^= _m; }
+                return *this;
+            }
+
+            //! Swap the sites referred to by a and b (used by std::swap_ranges).
+            friend void swap(reference a, reference b) {
+                int t=a; a = static_cast<int>(b); b = t;
+            }
+
+        protected:
+            word_type* _w; //!< Word containing this site.
+            word_type _m; //!< Mask selecting this site.
+        };
+
+        //! Iterator over sites.
+        class iterator : public boost::iterator_facade<iterator, int, std::random_access_iterator_tag, reference> {
+        public:
+            iterator() : _w(0), _i(0) { }
+            iterator(word_type* w, std::size_t i) : _w(w), _i(i) { }
+        protected:
+            friend class boost::iterator_core_access;
+            friend class packed_bitstring;
+            reference dereference() const { return reference(_w + _i/word_bits, word_type(1) << (_i%word_bits)); }
+            bool equal(const iterator& that) const { return _i == that._i; }
+            void increment() { ++_i; }
+            void decrement() { --_i; }
+            void advance(difference_type n) { _i += n; }
+            difference_type distance_to(const iterator& that) const {
+                return static_cast<difference_type>(that._i) - static_cast<difference_type>(_i);
+            }
+            word_type* _w; //!< Base of the word array.
+            std::size_t _i; //!< Site index.
+        };
+
+        //! Const iterator over sites.
+        class const_iterator : public boost::iterator_facade<const_iterator, int, std::random_access_iterator_tag, int> {
+        public:
+            const_iterator() : _w(0), _i(0) { }
+            const_iterator(const word_type* w, std::size_t i) : _w(w), _i(i) { }
+            const_iterator(const iterator& that) : _w(that._w), _i(that._i) { }
+        protected:
+            friend class boost::iterator_core_access;
+            int dereference() const { return (_w[_i/word_bits] >> (_i%word_bits)) & 0x01; }
+            bool equal(const const_iterator& that) const { return _i == that._i; }
+            void increment() { ++_i; }
+            void decrement() { --_i; }
+            void advance(difference_type n) { _i += n; }
+            difference_type distance_to(const const_iterator& that) const {
+                return static_cast<difference_type>(that._i) - static_cast<difference_type>(_i);
+            }
+            const word_type* _w; //!< Base of the word array.
+            std::size_t _i; //!< Site index.
+        };
+
+        //! Constructor.
+        packed_bitstring() : _size(0) {
+        }
+
+        //! Constructor that initializes to n sites of value v.
+        explicit packed_bitstring(std::size_t n, int v=0) : _size(0) {
+            resize(n, v);
+        }
+
+        //! Constructor from a range of sites.
+        template <typename InputIterator>
+        packed_bitstring(InputIterator f, InputIterator l,
+                         typename boost::disable_if<boost::is_integral<InputIterator> >::type* =0) : _size(0) {
+            for( ; f!=l; ++f) {
+                push_back(*f);
+            }
+        }
+
+        //! Returns the number of sites.
+        std::size_t size() const { return _size; }
+
+        //! Returns true if there are no sites.
+        bool empty() const { return _size == 0; }
+
+        //! Remove all sites.
+        void clear() { _words.clear(); _size = 0; }
+
+        //! Reserve storage for n sites.
+        void reserve(std::size_t n) { _words.reserve(nwords(n)); }
+
+        //! Resize to n sites; new sites are set to v.
+        void resize(std::size_t n, int v=0) {
+            std::size_t s=_size;
+            _words.resize(nwords(n), 0);
+            _size = n;
+            if(n > s) {
+                if(v) {
+                    for(std::size_t i=s; i<n; i+=word_bits) {
+                        std::size_t k=std::min(static_cast<std::size_t>(word_bits), n-i);
+                        set(i, k, ~word_type(0));
+                    }
+                }
+            } else {
+                mask_tail();
+            }
+        }
+
+        //! Append a site.
+        void push_back(int v) {
+            if((_size % word_bits) == 0) {
+                _words.push_back(0);
+            }
+            ++_size;
+            if(v) {
+                _words.back() |= word_type(1) << ((_size-1) % word_bits);
+            }
+        }
+
+        iterator begin() { return iterator(data(), 0); }
+        iterator end() { return iterator(data(), _size); }
+        const_iterator begin() const { return const_iterator(data(), 0); }
+        const_iterator end() const { return const_iterator(data(), _size); }
+
+        reference operator[](std::size_t i) {
+            return reference(&_words[i/word_bits], word_type(1) << (i%word_bits));
+        }
+
+        int operator[](std::size_t i) const {
+            return (_words[i/word_bits] >> (i%word_bits)) & 0x01;
+        }
+
+        //! Invert site i.
+        void flip(std::size_t i) {
+            _words[i/word_bits] ^= word_type(1) << (i%word_bits);
+        }
+
+        //! Invert all sites.
+        void flip() {
+            for(std::size_t i=0; i<_words.size(); ++i) {
+                _words[i] = ~_words[i];
+            }
+            mask_tail();
+        }
+
+        //! Returns the number of sites that are set.
+        std::size_t count() const {
+            std::size_t c=0;
+            for(std::size_t i=0; i<_words.size(); ++i) {
+                c += popcount(_words[i]);
+            }
+            return c;
+        }
+
+        /*! Returns the n<=64 sites starting at site i, packed into the low bits
+         of a word.
+         */
+        word_type get(std::size_t i, std::size_t n) const {
+            if(n == 0) {
+                return 0;
+            }
+            std::size_t w=i/word_bits, b=i%word_bits;
+            word_type r=_words[w] >> b;
+            if((b+n) > word_bits) {
+                r |= _words[w+1] << (word_bits-b);
+            }
+            return r & low_mask(n);
+        }
+
+        //! Set the n<=64 sites starting at site i from the low bits of v.
+        void set(std::size_t i, std::size_t n, word_type v) {
+            if(n == 0) {
+                return;
+            }
+            v &= low_mask(n);
+            std::size_t w=i/word_bits, b=i%word_bits;
+            word_type m=low_mask(n) << b;
+            _words[w] = (_words[w] & ~m) | (v << b);
+            if((b+n) > word_bits) {
+                std::size_t k=word_bits-b;
+                m = low_mask(n-k);
+                _words[w+1] = (_words[w+1] & ~m) | (v >> k);
+            }
+        }
+
+        //! Returns the number of storage words.
+        std::size_t num_words() const { return _words.size(); }
+
+        //! Returns a pointer to the storage words.
+        word_type* data() { return _words.empty() ? 0 : &_words[0]; }
+
+        //! Returns a const pointer to the storage words.
+        const word_type* data() const { return _words.empty() ? 0 : &_words[0]; }
+
+        //! Clear any bits in the last word that lie past size().
+        void mask_tail() {
+            std::size_t r=_size % word_bits;
+            if(r != 0) {
+                _words.back() &= low_mask(r);
+            }
+        }
+
+        bool operator==(const packed_bitstring& that) const {
+            return (_size == that._size) && (_words == that._words);
+        }
+
+        bool operator!=(const packed_bitstring& that) const {
+            return !operator==(that);
+        }
+
+        bool operator<(const packed_bitstring& that) const {
+            return std::lexicographical_compare(begin(), end(), that.begin(), that.end());
+        }
+
+        //! Returns a mask with the low n bits set.
+        static word_type low_mask(std::size_t n) {
+            return (n >= word_bits) ? ~word_type(0) : ((word_type(1) << n) - 1);
+        }
+
+        //! Returns the number of words needed to store n sites.
+        static std::size_t nwords(std::size_t n) {
+            return (n + word_bits - 1) / word_bits;
+        }
+
+        // These enable a more compact serialization of the genome.
+        template<class Archive>
+		void save(Archive & ar, const unsigned int version) const {
+			std::ostringstream out;
+			out << _size << std::hex;
+            for(std::size_t i=0; i<_words.size(); ++i) {
+                out << " " << _words[i];
+            }
+			std::string genome(out.str());
+			ar & BOOST_SERIALIZATION_NVP(genome);
+		}
+
+		template<class Archive>
+		void load(Archive & ar, const unsigned int version) {
+			std::string genome;
+			ar & BOOST_SERIALIZATION_NVP(genome);
+			std::istringstream in(genome);
+			std::size_t s;
+			in >> s >> std::hex;
+            _size = s;
+            _words.resize(nwords(s));
+            for(std::size_t i=0; i<_words.size(); ++i) {
+                in >> _words[i];
+            }
+            mask_tail();
+		}
+		BOOST_SERIALIZATION_SPLIT_MEMBER();
+
+    protected:
+        std::vector<word_type> _words; //!< Storage.
+        std::size_t _size; //!< Number of sites.
+    };
+
+    //! Returns the number of ones in g.
+    inline std::size_t count_ones(const packed_bitstring& g) {
+        return g.count();
+    }
+
+    /*! Swap n sites starting at a[i] with n sites starting at b[j], one word
+     at a time.
+     */
+    inline void swap_ranges(packed_bitstring& a, std::size_t i, packed_bitstring& b, std::size_t j, std::size_t n) {
+        while(n > 0) {
+            std::size_t k=std::min(n, static_cast<std::size_t>(packed_bitstring::word_bits));
+            packed_bitstring::word_type t=a.get(i,k);
+            a.set(i, k, b.get(j,k));
+            b.set(j, k, t);
+            i += k; j += k; n -= k;
+        }
+    }
+
+    namespace mutation {
+        namespace operators {
+
+            /*! Per-site bitflip mutation for packed bitstrings.
+
+             Equivalent to geometric_per_site<site::bitflip>, except that each
+             selected site is flipped in place in its word.
+             */
+            struct packed_bitflip {
+                template <typename EA>
+                void operator()(typename EA::individual_type& ind, EA& ea) {
+                    packed_bitstring& g=ind.genome();
+                    const double p=get<MUTATION_PER_SITE_P>(ea);
+                    if(p <= 0.0) {
+                        return;
+                    } else if(p >= 1.0) {
+                        g.flip();
+                        return;
+                    }
+
+                    geometric_skip skip(p);
+                    std::size_t i=0;
+                    for(;;) {
+                        std::size_t k=skip(ea.rng());
+                        if(k >= (g.size() - i)) {
+                            break;
+                        }
+                        i += k;
+                        g.flip(i);
+                        ++i;
+                    }
+                }
+            };
+
+        } // operators
+    } // mutation
+
+} // ea
+
+#endif
@@ -115,7 +115,35 @@ namespace ealib {
                 boost::add_edge(v, i->first, G[i->second], G);
             }
         }
-        
+
+        /*! Remove vertex u, and all edges incident to it, from G.
+
+         Vertices after u are renumbered, as they are by boost::remove_vertex.
+         We rebuild G instead of calling boost::remove_vertex, which increments
+         an erased iterator while renumbering set-based (setS) edge lists.
+         */
+        template <typename VertexDescriptor, typename Graph>
+        void erase_vertex(VertexDescriptor u, Graph& G) {
+            typedef typename Graph::vertex_descriptor vertex_descriptor;
+            Graph H(boost::num_vertices(G)-1);
+
+            typename Graph::vertex_iterator vi,vi_end;
+            for(boost::tie(vi,vi_end)=boost::vertices(G); vi!=vi_end; ++vi) {
+                if(*vi != u) {
+                    H[(*vi < u) ? *vi : (*vi-1)] = G[*vi];
+                }
+            }
+
+            typename Graph::edge_iterator ei,ei_end;
+            for(boost::tie(ei,ei_end)=boost::edges(G); ei!=ei_end; ++ei) {
+                vertex_descriptor s=boost::source(*ei,G), t=boost::target(*ei,G);
+                if((s != u) && (t != u)) {
+                    boost::add_edge((s < u) ? s : (s-1), (t < u) ? t : (t-1), G[*ei], H);
+                }
+            }
+            G.swap(H);
+        }
+
         /*! Independent probabilities:
          P_V is Node-event probability.
          P_E is Edge-event probability.
@@ -189,9 +217,7 @@ namespace ealib {
                 return;
             }
             
-            typename Graph::vertex_descriptor u=boost::vertex(rng(boost::num_vertices(G)),G);
-            boost::clear_vertex(u,G);
-            boost::remove_vertex(u,G);
+            erase_vertex(boost::vertex(rng(boost::num_vertices(G)),G), G);
         }
         
         //! Add an edge between two distinct randomly selected vertices.
@@ -248,8 +274,7 @@ namespace ealib {
             typename Graph::vertex_descriptor v=boost::vertex(vn,G);
             copy_in_edges(v,u,G);
             copy_out_edges(v,u,G);
-            boost::clear_vertex(v,G);
-            boost::remove_vertex(v,G);
+            erase_vertex(v,G);
         }
         
         /*! Perform n growth events on graph G via the given growth descriptor.
@@ -21,6 +21,7 @@
 #define _EA_INDIVIDUAL_H_
 
 #include <boost/serialization/nvp.hpp>
+#include <ea/individual_id.h>
 #include <ea/metadata.h>
 
 namespace ealib {
@@ -40,15 +41,15 @@ namespace ealib {
         typedef metadata md_type;
         
         //! Constructor.
-		individual() {
+		individual() : _id(0) {
 		}
         
 		//! Constructor that builds an individual from a genome.
-		individual(const genome_type& g) : _repr(g) {
+		individual(const genome_type& g) : _repr(g), _id(0) {
 		}
         
         //! Constructor that builds an individual from a representation.
-		individual(const representation_type& r) : _repr(r) {
+		individual(const representation_type& r) : _repr(r), _id(0) {
 		}
         
         //! Copy constructor.
@@ -56,6 +57,7 @@ namespace ealib {
             _repr = that._repr;
             _md = that._md;
             _traits = that._traits;
+            _id = that._id;
         }
         
         //! Assignment operator.
@@ -64,6 +66,7 @@ namespace ealib {
                 _repr = that._repr;
                 _md = that._md;
                 _traits = that._traits;
+                _id = that._id;
             }
             return *this;
         }
@@ -91,11 +94,18 @@ namespace ealib {
         
         //! Returns this individual's meta data (const-qualified).
         const metadata& md() const { return _md; }
+        
+        //! Returns this individual's identifier.
+        individual_id_type& id() { return _id; }
+        
+        //! Returns this individual's identifier (const-qualified).
+        individual_id_type id() const { return _id; }
 
     protected:
         representation_type _repr; //!< This individual's representation.
         traits_type _traits; //!< This individual's traits.
         metadata _md; //!< This individual's meta data.
+        individual_id_type _id; //!< This individual's identifier.
         
     private:
         friend class boost::serialization::access;
@@ -105,7 +115,7 @@ namespace ealib {
         void serialize(Archive& ar, const unsigned int version) {
             ar & boost::serialization::make_nvp("representation", _repr);
             ar & boost::serialization::make_nvp("traits", _traits);
-            ar & boost::serialization::make_nvp("metadata", _md);
+            detail::serialize_individual_md(ar, "metadata", _id, _md);
         }
     };
     
@@ -0,0 +1,194 @@
+/* individual_id.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_INDIVIDUAL_ID_H_
+#define _EA_INDIVIDUAL_ID_H_
+
+#include <string>
+#include <boost/cstdint.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <ea/exceptions.h>
+#include <ea/metadata.h>
+
+namespace ealib {
+    
+    /*! Type for individual identifiers.
+     
+     Each EA hands out monotonically increasing identifiers to the individuals
+     born in it from its id stream, a range of identifiers that share a prefix.
+     The identifiers of a top-level EA, and of the subpopulations of a
+     top-level metapopulation, hold a 24-bit stream number in their high bits
+     and a 40-bit counter in their low bits; the metapopulation itself uses
+     stream 0, and gives each subpopulation it makes or copies a new stream.
+     Nested metapopulations instead carve their subpopulations' streams out of
+     their own, with a 16-bit index and a counter 16 bits narrower (see
+     child_individual_id_stream), so that identifiers are unique across the
+     whole hierarchy.  Exhausting a stream, or the streams available to a
+     metapopulation, throws rather than reusing identifiers.
+     
+     Zero means "no identifier"; e.g., for individuals loaded from checkpoints
+     that predate identifiers.
+     */
+    typedef boost::uint64_t individual_id_type;
+    
+    //! Next identifier to be handed out by an EA; only used for checkpointing.
+    LIBEA_MD_DECL(NEXT_INDIVIDUAL_ID, "ea.individual.next_id", individual_id_type);
+    
+    //! Id stream of an EA; only used for checkpointing.
+    LIBEA_MD_DECL(INDIVIDUAL_ID_STREAM, "ea.individual.id_stream", individual_id_type);
+    
+    namespace detail {
+        /* An id stream is encoded as its first identifier less one, with the
+         width of its counter in the low 8 bits (which are otherwise zero, as
+         counters are at least 16 bits wide).  A width of 0 means 40, so that
+         stream 0 is that of a top-level EA.
+         */
+        const unsigned int TOP_LEVEL_ID_BITS=40; //!< Counter width of top-level streams.
+        const unsigned int TOP_LEVEL_STREAM_BITS=24; //!< Width of top-level stream numbers.
+        const unsigned int NESTED_STREAM_BITS=16; //!< Width of nested stream indices.
+        const unsigned int MIN_ID_BITS=16; //!< Minimum counter width.
+        
+        //! Returns the counter width of an id stream.
+        inline unsigned int individual_id_bits(individual_id_type stream) {
+            unsigned int bits=static_cast<unsigned int>(stream & 0xffULL);
+            return (bits == 0) ? TOP_LEVEL_ID_BITS : bits;
+        }
+        
+        //! Returns the identifier preceding the first of an id stream.
+        inline individual_id_type individual_id_base(individual_id_type stream) {
+            return stream & ~0xffULL;
+        }
+    } // detail
+    
+    //! Returns the first identifier of the given id stream.
+    inline individual_id_type first_individual_id(individual_id_type stream) {
+        return detail::individual_id_base(stream) + 1;
+    }
+    
+    /*! Returns next, the next identifier in the given id stream, and advances
+     it; throws if the stream is exhausted.
+     */
+    inline individual_id_type take_individual_id(individual_id_type& next, individual_id_type stream) {
+        if(((next - detail::individual_id_base(stream)) >> detail::individual_id_bits(stream)) != 0) {
+            throw fatal_error_exception("individual identifiers exhausted in id stream " + boost::lexical_cast<std::string>(stream) + ".");
+        }
+        return next++;
+    }
+    
+    /*! Returns a new id stream for a subpopulation of an EA with the given id
+     stream, derived from id, an identifier just taken from that stream.
+     
+     The subpopulations of a top-level EA (stream 0) are given the next
+     top-level stream.  Otherwise, the subpopulation's stream is a block of the
+     parent's stream, indexed by id; the parent's own identifiers, which are
+     taken from the same counter, stay in block 0.  Throws if id is beyond the
+     available streams, or nesting leaves too narrow a counter.
+     */
+    inline individual_id_type child_individual_id_stream(individual_id_type id, individual_id_type stream) {
+        using namespace detail;
+        const individual_id_type base=individual_id_base(stream);
+        const unsigned int bits=individual_id_bits(stream);
+        const individual_id_type k=id - base;
+        if(base == 0) {
+            if((k >> TOP_LEVEL_STREAM_BITS) != 0) {
+                throw fatal_error_exception("individual id streams exhausted.");
+            }
+            return k << TOP_LEVEL_ID_BITS;
+        }
+        if(((k >> NESTED_STREAM_BITS) != 0) || (bits < (MIN_ID_BITS + NESTED_STREAM_BITS))) {
+            throw fatal_error_exception("individual id streams exhausted in id stream " + boost::lexical_cast<std::string>(stream) + ".");
+        }
+        const unsigned int child_bits=bits - NESTED_STREAM_BITS;
+        return base | (k << child_bits) | child_bits;
+    }
+    
+    namespace detail {
+        
+        //! Restore an individual's identifier from its meta-data.
+        inline void load_individual_id(individual_id_type& id, metadata& md) {
+            id = 0;
+            if(exists<IND_UNIQUE_NAME>(md)) {
+                try {
+                    id = boost::lexical_cast<individual_id_type>(get<IND_UNIQUE_NAME>(md));
+                } catch(boost::bad_lexical_cast&) {
+                    // a name that isn't an identifier (e.g., a uuid); leave it be.
+                }
+            }
+        }
+        
+        /*! Serialize an individual's meta-data, with its identifier stored as
+         IND_UNIQUE_NAME so that checkpoints remain readable by tools that
+         expect a name.  The name is added to a copy of the meta-data, so that
+         saving doesn't modify it.
+         */
+        template <class Archive>
+        void serialize_individual_md(Archive& ar, const char* name, individual_id_type& id, metadata& md) {
+            if(Archive::is_saving::value && (id != 0)) {
+                metadata m(md);
+                put<IND_UNIQUE_NAME>(boost::lexical_cast<std::string>(id), m);
+                ar & boost::serialization::make_nvp(name, m);
+            } else {
+                ar & boost::serialization::make_nvp(name, md);
+            }
+            if(Archive::is_loading::value) {
+                load_individual_id(id, md);
+            }
+        }
+        
+        /*! Serialize an EA's meta-data, with its next identifier and id stream
+         (see serialize_individual_md).
+         */
+        template <class Archive>
+        void serialize_ea_md(Archive& ar, const char* name, individual_id_type& next, individual_id_type& stream, metadata& md) {
+            if(Archive::is_saving::value) {
+                metadata m(md);
+                put<NEXT_INDIVIDUAL_ID>(next, m);
+                put<INDIVIDUAL_ID_STREAM>(stream, m);
+                ar & boost::serialization::make_nvp(name, m);
+            } else {
+                ar & boost::serialization::make_nvp(name, md);
+            }
+            if(Archive::is_loading::value && exists<NEXT_INDIVIDUAL_ID>(md)) {
+                next = get<NEXT_INDIVIDUAL_ID>(md);
+                if(exists<INDIVIDUAL_ID_STREAM>(md)) {
+                    stream = get<INDIVIDUAL_ID_STREAM>(md);
+                } else {
+                    // checkpoints that predate nested streams are top-level:
+                    stream = ((next - 1) >> TOP_LEVEL_ID_BITS) << TOP_LEVEL_ID_BITS;
+                }
+            }
+        }
+        
+    } // detail
+    
+    /*! Returns the unique name of an individual: its identifier in decimal if
+     it has one, or else its IND_UNIQUE_NAME (empty if it has neither).
+     */
+    template <typename Individual>
+    std::string unique_name(Individual& ind) {
+        if(ind.id() != 0) {
+            return boost::lexical_cast<std::string>(ind.id());
+        }
+        return exists<IND_UNIQUE_NAME>(ind) ? get<IND_UNIQUE_NAME>(ind) : std::string();
+    }
+    
+} // ealib
+
+#endif
@@ -26,13 +26,31 @@
 #include <boost/any.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/program_options.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/is_base_of.hpp>
 
+#include <cassert>
+#include <new>
 #include <string>
 #include <map>
+#include <vector>
 
 #include <ea/exceptions.h>
 
+/* Maximum number of attributes that can be declared with LIBEA_MD_SLOT_DECL. */
+#ifndef LIBEA_MD_MAX_SLOTS
+#define LIBEA_MD_MAX_SLOTS 8
+#endif
+
+/* Size, in bytes, of the inline storage for each slotted attribute's value. */
+#ifndef LIBEA_MD_SLOT_SIZE
+#define LIBEA_MD_SLOT_SIZE 32
+#endif
+
 namespace ealib {
     
     //! ABC for attribute types.
@@ -76,6 +94,146 @@ namespace ealib {
         
         value_type _value; //!< This attribute's value.
     };
+    
+    namespace detail {
+        
+        //! Tag base class for attributes that are stored in slots (see LIBEA_MD_SLOT_DECL).
+        struct slotted_attribute {
+        };
+        
+        //! Selects the slotted metadata path for attributes declared with LIBEA_MD_SLOT_DECL.
+        template <typename Attribute>
+        struct is_slotted : boost::is_base_of<slotted_attribute, Attribute> {
+        };
+        
+        //! Type-specific operations on a value stored in a slot.
+        struct slot_ops {
+            void (*copy)(void* dst, const void* src); //!< Copy-construct *src into dst.
+            void (*destroy)(void* p); //!< Destroy the value at p.
+            std::string (*to_string)(const void* p); //!< Convert the value at p to a string.
+        };
+        
+        //! slot_ops for values of type T.
+        template <typename T>
+        struct slot_ops_impl {
+            static void copy(void* dst, const void* src) { new (dst) T(*static_cast<const T*>(src)); }
+            static void destroy(void* p) { static_cast<T*>(p)->~T(); }
+            static std::string to_string(const void* p) { return boost::lexical_cast<std::string>(*static_cast<const T*>(p)); }
+            
+            //! Returns the operations for T.
+            static const slot_ops* ops() {
+                static const slot_ops o = { &copy, &destroy, &to_string };
+                return &o;
+            }
+        };
+        
+        /*! Storage for a single slotted attribute's value, held inline.
+         
+         A slot is empty until a value is constructed in it; its value is then
+         read and written in place.
+         */
+        struct slot_value {
+            typedef boost::aligned_storage<LIBEA_MD_SLOT_SIZE>::type storage_type;
+            
+            //! Constructor.
+            slot_value() : ops(0) {
+            }
+            
+            //! Returns true if this slot holds a value.
+            bool full() const { return ops != 0; }
+            
+            //! Returns this slot's value.
+            template <typename T>
+            T& value() { return *static_cast<T*>(static_cast<void*>(&storage)); }
+            
+            //! Construct value t in this (empty) slot.
+            template <typename T>
+            T& construct(const T& t) {
+                BOOST_STATIC_ASSERT(sizeof(T) <= sizeof(storage_type));
+                new (&storage) T(t);
+                ops = slot_ops_impl<T>::ops();
+                return value<T>();
+            }
+            
+            //! Copy that into this (empty) slot.
+            void copy(const slot_value& that) {
+                if(that.full()) {
+                    that.ops->copy(&storage, &that.storage);
+                    ops = that.ops;
+                }
+            }
+            
+            //! Destroy the value in this slot, if any.
+            void reset() {
+                if(full()) {
+                    ops->destroy(&storage);
+                    ops = 0;
+                }
+            }
+            
+            //! Convert this slot's value to a string.
+            std::string to_string() const { return ops->to_string(&storage); }
+            
+            const slot_ops* ops; //!< Operations on the value, or 0 if empty.
+            storage_type storage; //!< The value.
+        };
+        
+        /*! Process-wide registry of slotted attribute keys.
+         
+         Each slotted attribute is assigned the next slot index when it is
+         registered; that index is then fixed for the life of the process.  The
+         registry is only consulted for string-keyed access and serialization.
+         
+         Slotted attributes are registered during static initialization (see
+         LIBEA_MD_SLOT_DECL), before any thread that reads meta-data is
+         started, so the registry does not change once main() has begun, and
+         is read without locking.
+         */
+        class slot_registry {
+        public:
+            //! Returns the registry.
+            static slot_registry& instance() {
+                static slot_registry r;
+                return r;
+            }
+            
+            //! Assign a slot to key k.
+            std::size_t add(const std::string& k) {
+                boost::mutex::scoped_lock lock(_mutex);
+                std::map<std::string,std::size_t>::iterator i=_slots.find(k);
+                if(i != _slots.end()) {
+                    return i->second;
+                }
+                if(_keys.size() >= LIBEA_MD_MAX_SLOTS) {
+                    throw fatal_error_exception("metadata: too many slotted attributes; increase LIBEA_MD_MAX_SLOTS");
+                }
+                _keys.push_back(k);
+                _slots[k] = _keys.size()-1;
+                return _keys.size()-1;
+            }
+            
+            //! Retrieve the slot for key k; returns false if k is not slotted.
+            bool find(const std::string& k, std::size_t& s) {
+                std::map<std::string,std::size_t>::iterator i=_slots.find(k);
+                if(i == _slots.end()) {
+                    return false;
+                }
+                s = i->second;
+                return true;
+            }
+            
+            //! Returns the key for slot s.
+            const std::string& key(std::size_t s) {
+                return _keys[s];
+            }
+            
+        protected:
+            std::vector<std::string> _keys; //!< Key for each slot.
+            std::map<std::string,std::size_t> _slots; //!< Slot for each key.
+            boost::mutex _mutex; //!< Serializes registration.
+        };
+        
+    } // detail
 
     
 	/*! Meta-data is a collection of string covertible key-value pairs (attributes).
@@ -91,6 +249,20 @@ namespace ealib {
      
      At runtime, the string versions of attributes are lazily converted to their
      native representation.
+     
+     Attributes declared with LIBEA_MD_SLOT_DECL (typically those that are read
+     and written for every individual) are instead stored inline, in a fixed
+     array indexed by their slot, so that get, put, and exists on them do not
+     build key strings, compare keys, convert strings, or allocate (except to
+     copy a value that itself allocates, e.g., a long std::string).  They are
+     converted to strings only for serialization, and so are indistinguishable
+     from other attributes in archives and via string-keyed access.
+
+     While concurrent() (e.g., while a scheduler executes individuals on multiple
+     threads), meta-data may be read, but not written, from multiple threads:
+     values already converted are read without locking, and values converted
+     during this time are held in a separate, locked cache that is merged into
+     the main cache when concurrent(false) is called.
 
 	 Meta-data is used with the free functions get, put, exists, and next (which
      is a convenient test-and-inc).
@@ -105,29 +277,51 @@ namespace ealib {
 		metadata() { }
 		
 		//! Destructor.
-		virtual ~metadata() { }
+		virtual ~metadata() {
+            clear_slots();
+        }
 		
-		//! Copy-constructor.
+		//! Copy-constructor; the copy is not concurrent.
 		metadata(const metadata& that) {
 			_strings = that._strings;
-            _values = that._values;
+            copy_values(that);
+            copy_slots(that);
 		}
 		
-		//! Assignment operator.
+		//! Assignment operator; concurrency is not assigned.
 		metadata& operator=(const metadata& that) {
 			if(this != &that) {
 				_strings = that._strings;
-                _values = that._values;
+                copy_values(that);
+                clear_slots();
+                copy_slots(that);
 			}
 			return *this;
 		}
+        
+        //! Returns true if this meta-data may be read from multiple threads.
+        bool concurrent() const { return _concurrent != 0; }
+        
+        /*! Sets whether this meta-data may be read from multiple threads; it
+         must not be written while concurrent.
+         */
+        void concurrent(bool c) {
+            if(c && !_concurrent) {
+                _concurrent.reset(new concurrent_cache());
+            } else if(!c && _concurrent) {
+                _values.insert(_concurrent->values.begin(), _concurrent->values.end());
+                _concurrent.reset();
+            }
+        }
 		
         //! Copy meta-data from that to this (may overwrite this).
         metadata& operator+=(const metadata& that) {
             if(this != &that) {
+                assert(!_concurrent);
                 flush();
                 const_cast<metadata*>(&that)->flush();
                 _values.clear();
+                clear_slots();
                 for(md_string_type::const_iterator i=that._strings.begin(); i!=that._strings.end(); ++i) {
 					_strings[i->first] = i->second;
                 }
@@ -156,27 +350,205 @@ namespace ealib {
 		//! Returns a reference to an attribute's value.
         template <typename Attribute>
         typename Attribute::reference_type getattr(const std::string& k) {
+            return getattr_impl<Attribute>(k, typename detail::is_slotted<Attribute>::type());
+        }
+
+        //! Returns a reference to an attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getattr(const std::string& k, const typename Attribute::value_type v) {
+            return getattr_impl<Attribute>(k, v, typename detail::is_slotted<Attribute>::type());
+        }
+
+        //! Sets an attributes value.
+        template <typename Attribute>
+        typename Attribute::reference_type setattr(const std::string& k, const typename Attribute::value_type v) {
+            return setattr_impl<Attribute>(k, v, typename detail::is_slotted<Attribute>::type());
+        }
+        
+        //! Returns a reference to a slotted attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getslot() {
+            if(_concurrent) {
+                boost::mutex::scoped_lock lock(_concurrent->mutex);
+                return getslot_impl<Attribute>();
+            }
+            return getslot_impl<Attribute>();
+        }
+        
+        //! Returns a reference to a slotted attribute's value, setting it to v if it is not present.
+        template <typename Attribute>
+        typename Attribute::reference_type getslot(const typename Attribute::value_type v) {
+            if(_concurrent) {
+                boost::mutex::scoped_lock lock(_concurrent->mutex);
+                return getslot_impl<Attribute>(v);
+            }
+            return getslot_impl<Attribute>(v);
+        }
+        
+        //! Sets a slotted attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type setslot(const typename Attribute::value_type v) {
+            assert(!_concurrent);
+            typedef typename Attribute::value_type value_type;
+            detail::slot_value& sv=_slots[Attribute::slot()];
+            if(!sv.full()) {
+                return sv.construct(v);
+            }
+            value_type& r=sv.value<value_type>();
+            r = v;
+            return r;
+        }
+        
+        //! Returns true if a slotted attribute is present.
+        template <typename Attribute>
+        bool hasslot() {
+            return _slots[Attribute::slot()].full()
+            || (find_string(Attribute::key()) != _strings.end());
+        }
+        
+        /*! Bypass type conversions, and store the string version of an attribute directly.
+
+         This causes a string conversion on the first getattr call with this key, but is
+         necessary because we don't actually know the type in question here.
+         */
+		void set(const std::string& k, const std::string& v) {
+            assert(!_concurrent);
+			_strings[k] = v;
+            _values.erase(k);
+            std::size_t s;
+            if(detail::slot_registry::instance().find(k,s)) {
+                _slots[s].reset();
+            }
+		}
+
+		//! Check to see if meta-data with key k exists.
+		bool exists(const std::string& k) {
+			if((_values.find(k) != _values.end()) || (_strings.find(k) != _strings.end())) {
+                return true;
+            }
+            if(_concurrent) {
+                boost::mutex::scoped_lock lock(_concurrent->mutex);
+                if(_concurrent->values.find(k) != _concurrent->values.end()) {
+                    return true;
+                }
+            }
+            std::size_t s;
+            return detail::slot_registry::instance().find(k,s) && _slots[s].full();
+		}
+		
+		//! Clear all meta data.
+		void clear() {
+            assert(!_concurrent);
+			_strings.clear();
+			_values.clear();
+            clear_slots();
+		}
+		
+	private:
+        //! Cache for values converted while concurrent.
+        struct concurrent_cache {
+            boost::mutex mutex; //!< Protects this cache, and empty slots.
+            md_value_type values; //!< Values converted while concurrent.
+        };
+        
+		md_string_type _strings; //!< Container for meta-data.
+		md_value_type _values; //!< Cache for meta-data (not ever serialized).
+        detail::slot_value _slots[LIBEA_MD_MAX_SLOTS]; //!< Slotted attributes, indexed by slot (not ever serialized).
+        boost::shared_ptr<concurrent_cache> _concurrent; //!< Cache for concurrent misses; non-null while concurrent.
+        
+        //! Returns a reference to a slotted attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getslot_impl() {
+            typedef typename Attribute::value_type value_type;
+            detail::slot_value& sv=_slots[Attribute::slot()];
+            if(!sv.full()) {
+                md_string_type::iterator j=find_string(Attribute::key());
+                if(j == _strings.end()) {
+                    throw uninitialized_metadata_exception(Attribute::key());
+                }
+                return sv.construct(boost::lexical_cast<value_type>(j->second));
+            }
+            return sv.value<value_type>();
+        }
+        
+        //! Returns a reference to a slotted attribute's value, setting it to v if it is not present.
+        template <typename Attribute>
+        typename Attribute::reference_type getslot_impl(const typename Attribute::value_type v) {
+            typedef typename Attribute::value_type value_type;
+            detail::slot_value& sv=_slots[Attribute::slot()];
+            if(!sv.full()) {
+                md_string_type::iterator j=find_string(Attribute::key());
+                if(j == _strings.end()) {
+                    return sv.construct(v);
+                }
+                return sv.construct(boost::lexical_cast<value_type>(j->second));
+            }
+            return sv.value<value_type>();
+        }
+        
+        //! Returns a reference to a slotted attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getattr_impl(const std::string& k, boost::true_type) {
+            return getslot<Attribute>();
+        }
+        
+        //! Returns a reference to a keyed attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getattr_impl(const std::string& k, boost::false_type) {
 			md_value_type::iterator i=_values.find(k);
 			if(i == _values.end()) {
 				// cache miss:
+                if(_concurrent) {
+                    boost::mutex::scoped_lock lock(_concurrent->mutex);
+                    return convert<Attribute>(k, _concurrent->values);
+                }
+                return convert<Attribute>(k, _values);
+			}
+			return static_cast<Attribute*>(i->second.get())->value();
+		}
+        
+        //! Returns a reference to an attribute's value in cache c, converting it if needed.
+        template <typename Attribute>
+        typename Attribute::reference_type convert(const std::string& k, md_value_type& c) {
+            md_value_type::iterator i=c.find(k);
+            if(i == c.end()) {
 				md_string_type::iterator j=_strings.find(k);
 				if(j == _strings.end()) {
 					throw uninitialized_metadata_exception(k);
 				}
-                // convert the attr:
                 attr_ptr_type p(new Attribute());
                 p->from_string(j->second);
-				i = _values.insert(std::make_pair(k,p)).first;
-			}
+				i = c.insert(std::make_pair(k,p)).first;
+            }
 			return static_cast<Attribute*>(i->second.get())->value();
-		}
-
-        //! Returns a reference to an attribute's value.
+        }
+        
+        //! Returns a reference to a slotted attribute's value.
         template <typename Attribute>
-        typename Attribute::reference_type getattr(const std::string& k, const typename Attribute::value_type v) {
+        typename Attribute::reference_type getattr_impl(const std::string& k, const typename Attribute::value_type v, boost::true_type) {
+            return getslot<Attribute>(v);
+        }
+        
+        //! Returns a reference to a keyed attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type getattr_impl(const std::string& k, const typename Attribute::value_type v, boost::false_type) {
 			md_value_type::iterator i=_values.find(k);
 			if(i == _values.end()) {
 				// cache miss:
+                if(_concurrent) {
+                    boost::mutex::scoped_lock lock(_concurrent->mutex);
+                    return convert<Attribute>(k, v, _concurrent->values);
+                }
+                return convert<Attribute>(k, v, _values);
+			}
+			return static_cast<Attribute*>(i->second.get())->value();
+		}
+        
+        //! Returns a reference to an attribute's value in cache c, converting it or setting it to v if needed.
+        template <typename Attribute>
+        typename Attribute::reference_type convert(const std::string& k, const typename Attribute::value_type v, md_value_type& c) {
+            md_value_type::iterator i=c.find(k);
+            if(i == c.end()) {
                 attr_ptr_type p(new Attribute());
 				md_string_type::iterator j=_strings.find(k);
                 if(j == _strings.end()) {
@@ -184,14 +556,21 @@ namespace ealib {
                 } else {
                     p->from_string(j->second);
                 }
-                i = _values.insert(std::make_pair(k,p)).first;
-			}
+                i = c.insert(std::make_pair(k,p)).first;
+            }
 			return static_cast<Attribute*>(i->second.get())->value();
-		}
-
-        //! Sets an attributes value.
+        }
+        
+        //! Sets a slotted attribute's value.
         template <typename Attribute>
-        typename Attribute::reference_type setattr(const std::string& k, const typename Attribute::value_type v) {
+        typename Attribute::reference_type setattr_impl(const std::string& k, const typename Attribute::value_type v, boost::true_type) {
+            return setslot<Attribute>(v);
+        }
+        
+        //! Sets a keyed attribute's value.
+        template <typename Attribute>
+        typename Attribute::reference_type setattr_impl(const std::string& k, const typename Attribute::value_type v, boost::false_type) {
+            assert(!_concurrent);
             md_value_type::iterator i=_values.find(k);
 			if(i == _values.end()) {
                 // build the attr:
@@ -203,44 +582,47 @@ namespace ealib {
             return attr->value();
 		}
         
-        /*! Bypass type conversions, and store the string version of an attribute directly.
-
-         This causes a string conversion on the first getattr call with this key, but is
-         necessary because we don't actually know the type in question here.
-         */
-		void set(const std::string& k, const std::string& v) {
-			_strings[k] = v;
-            _values.erase(k);
-		}
-
-		//! Check to see if meta-data with key k exists.
-		bool exists(const std::string& k) {
-			md_value_type::iterator i=_values.find(k);
-			if(i == _values.end()) {
-				// cache miss:
-				md_string_type::iterator j=_strings.find(k);
-				if(j == _strings.end()) {
-					return false;
-				}
-			}
-			return true;
-		}
-		
-		//! Clear all meta data.
-		void clear() {
-			_strings.clear();
-			_values.clear();
-		}
-		
-	private:			
-		md_string_type _strings; //!< Container for meta-data.
-		md_value_type _values; //!< Cache for meta-data (not ever serialized).
-		
+        //! Returns the string for key k, or _strings.end(); builds no string if there are none.
+        md_string_type::iterator find_string(const char* k) {
+            if(_strings.empty()) {
+                return _strings.end();
+            }
+            return _strings.find(k);
+        }
+        
+        //! Copy the converted values of that into this.
+        void copy_values(const metadata& that) {
+            _values = that._values;
+            if(that._concurrent) {
+                boost::mutex::scoped_lock lock(that._concurrent->mutex);
+                _values.insert(that._concurrent->values.begin(), that._concurrent->values.end());
+            }
+        }
+        
+        //! Copy the slotted attributes of that into this (empty) metadata.
+        void copy_slots(const metadata& that) {
+            for(std::size_t i=0; i<LIBEA_MD_MAX_SLOTS; ++i) {
+                _slots[i].copy(that._slots[i]);
+            }
+        }
+        
+        //! Destroy all slotted attributes.
+        void clear_slots() {
+            for(std::size_t i=0; i<LIBEA_MD_MAX_SLOTS; ++i) {
+                _slots[i].reset();
+            }
+        }
+        
         //! Convert all values to strings.
         void flush() {
             for(md_value_type::iterator i=_values.begin(); i!=_values.end(); ++i) {
                 _strings[i->first] = i->second->to_string();
             }
+            for(std::size_t i=0; i<LIBEA_MD_MAX_SLOTS; ++i) {
+                if(_slots[i].full()) {
+                    _strings[detail::slot_registry::instance().key(i)] = _slots[i].to_string();
+                }
+            }
         }
         
 		friend class boost::serialization::access;
@@ -251,22 +633,70 @@ namespace ealib {
 		}		
 	};
     
+    namespace detail {
+        
+        /* Free-function access to slotted attributes goes directly to their
+         slots, and so never builds a key string.
+         */
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type get(HasMetaData& hmd, boost::true_type) {
+            return hmd.md().template getslot<Attribute>();
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type get(HasMetaData& hmd, boost::false_type) {
+            return hmd.md().template getattr<Attribute>(Attribute::key());
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type get(HasMetaData& hmd, const typename Attribute::value_type def, boost::true_type) {
+            return hmd.md().template getslot<Attribute>(def);
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type get(HasMetaData& hmd, const typename Attribute::value_type def, boost::false_type) {
+            return hmd.md().template getattr<Attribute>(Attribute::key(),def);
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type put(const typename Attribute::value_type v, HasMetaData& hmd, boost::true_type) {
+            return hmd.md().template setslot<Attribute>(v);
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        typename Attribute::reference_type put(const typename Attribute::value_type v, HasMetaData& hmd, boost::false_type) {
+            return hmd.md().template setattr<Attribute>(Attribute::key(), v);
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        bool exists(HasMetaData& hmd, boost::true_type) {
+            return hmd.md().template hasslot<Attribute>();
+        }
+        
+        template <typename Attribute, typename HasMetaData>
+        bool exists(HasMetaData& hmd, boost::false_type) {
+            return hmd.md().exists(Attribute::key());
+        }
+        
+    } // detail
+    
     //! Returns a reference to the given attribute's value.
     template <typename Attribute, typename HasMetaData>
     typename Attribute::reference_type get(HasMetaData& hmd) {
-        return hmd.md().template getattr<Attribute>(Attribute::key());
+        return detail::get<Attribute>(hmd, typename detail::is_slotted<Attribute>::type());
     }
     
     //! Returns a reference to the given attribute, setting it a default value if it is not present.
     template <typename Attribute, typename HasMetaData>
     typename Attribute::reference_type get(HasMetaData& hmd, const typename Attribute::value_type def) {
-        return hmd.md().template getattr<Attribute>(Attribute::key(),def);
+        return detail::get<Attribute>(hmd, def, typename detail::is_slotted<Attribute>::type());
     }
     
     //! Sets the value of the given attribute, and returns a reference to it.
     template <typename Attribute, typename HasMetaData>
     typename Attribute::reference_type put(const typename Attribute::value_type v, HasMetaData& hmd) {
-        return hmd.md().template setattr<Attribute>(Attribute::key(), v);
+        return detail::put<Attribute>(v, hmd, typename detail::is_slotted<Attribute>::type());
     }
     
     //! Sets the string for the given value.
@@ -278,7 +708,7 @@ namespace ealib {
     //! Returns true if the attribute exists, false otherwise.
     template <typename Attribute, typename HasMetaData>
     bool exists(HasMetaData& hmd) {
-        return hmd.md().exists(Attribute::key());
+        return detail::exists<Attribute>(hmd, typename detail::is_slotted<Attribute>::type());
     }
     
     //! Increment and set an attribute.
@@ -304,10 +734,25 @@ struct name : ealib::attribute<type> { \
     inline static const char* key() { return key_string; } \
 }
 
+/* This macro defines a new slotted attribute, which is accessed by index rather
+ than by key; use it for attributes that are accessed very frequently, e.g., for
+ every individual.  The attribute is registered during static initialization of
+ each translation unit that declares it (see detail::slot_registry). */
+#define LIBEA_MD_SLOT_DECL( name, key_string, type ) \
+struct name : ealib::attribute<type>, ealib::detail::slotted_attribute { \
+    virtual ~name() { } \
+    inline static const char* key() { return key_string; } \
+    inline static std::size_t slot() { \
+        static const std::size_t s=ealib::detail::slot_registry::instance().add(key_string); \
+        return s; \
+    } \
+}; \
+static const std::size_t name##_slot_registration=name::slot()
+
 namespace ealib {
-	LIBEA_MD_DECL(IND_UNIQUE_NAME, "individual.unique_name", std::string);
-    LIBEA_MD_DECL(IND_GENERATION, "individual.generation", double);
-    LIBEA_MD_DECL(IND_BIRTH_UPDATE, "individual.birth_update", long);
+	LIBEA_MD_SLOT_DECL(IND_UNIQUE_NAME, "individual.unique_name", std::string);
+    LIBEA_MD_SLOT_DECL(IND_GENERATION, "individual.generation", double);
+    LIBEA_MD_SLOT_DECL(IND_BIRTH_UPDATE, "individual.birth_update", long);
     
     LIBEA_MD_DECL(POPULATION_SIZE, "ea.population.size", unsigned int);
     LIBEA_MD_DECL(METAPOPULATION_SIZE, "ea.metapopulation.size", unsigned int);
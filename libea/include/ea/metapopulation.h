@@ -99,11 +99,13 @@ namespace ealib {
         class state_type {
         public:
             //! Default constructor.
-            state_type() : update(0) {
+            state_type() : update(0), next_id(first_individual_id(0)), id_stream(0) {
             }
             
             // assignable:
             unsigned long update; //!< Update number for this EA.
+            individual_id_type next_id; //!< Identifier of the next individual born in this EA.
+            individual_id_type id_stream; //!< Id stream from which identifiers are taken.
             rng_type rng; //!< Random number generator.
             md_type md; //!< Meta-data for this evolutionary algorithm instance.
             fitness_function_type fitness_function; //!< Fitness function object.
@@ -126,7 +128,7 @@ namespace ealib {
             void serialize(Archive & ar, const unsigned int version) {
                 ar & BOOST_SERIALIZATION_NVP(update);
                 ar & BOOST_SERIALIZATION_NVP(rng);
-                ar & BOOST_SERIALIZATION_NVP(md);
+                detail::serialize_ea_md(ar, "md", next_id, id_stream, md);
                 ar & BOOST_SERIALIZATION_NVP(population);
             }
         };
@@ -176,6 +178,8 @@ namespace ealib {
                     // events, isa, etc).  copy the easy parts of state first:
                     _state->update = that._state->update;
                     _state->rng = that._state->rng;
+                    _state->next_id = that._state->next_id;
+                    _state->id_stream = that._state->id_stream;
                     _state->md = that._state->md;
                     _state->fitness_function = that._state->fitness_function;
                     _state->stop = that._state->stop;
@@ -208,7 +212,8 @@ namespace ealib {
                 _state->md = md;
                 
                 if(exists<RNG_SEED>(*this)) {
-                    _state->rng.reset(get<RNG_SEED>(*this));
+                    // a seed of 0 seeds from the clock; save the seed that was used:
+                    put<RNG_SEED>(_state->rng.reset(get<RNG_SEED>(*this)), *this);
                 } else {
                     unsigned int s = _state->rng.seed();
                     _state->rng.reset(s);
@@ -257,20 +262,27 @@ namespace ealib {
             individual_ptr_type p(new individual_type(r));
             if(p->has_state()) {
                 p->reset_rng(_state->rng.seed());
+                p->reset_individual_ids(next_individual_id_stream());
             }
             return p;
         }
         
-        //! Returns a copy of an individual.
+        /*! Returns a copy of an individual.
+         
+         The copy is given its own id stream, so that individuals born in it
+         don't share identifiers with those born in the original.
+         */
         individual_ptr_type copy_individual(const individual_type& ind) {
             individual_ptr_type p(new individual_type(ind));
+            if(p->has_state()) {
+                p->reset_individual_ids(next_individual_id_stream());
+            }
             return p;
         }
 
         //! Resets this EA's RNG seed.
         void reset_rng(unsigned int s) {
-            put<RNG_SEED>(s,*this); // save the seed!
-            _state->rng.reset(s);
+            put<RNG_SEED>(_state->rng.reset(s), *this); // save the seed!
         }
         
         //! Returns true if this instance of digital_evolution has state.
@@ -278,6 +290,20 @@ namespace ealib {
             return _state != 0;
         }
         
+        //! Returns the identifier for the next individual born in this EA.
+        individual_id_type next_individual_id() { return take_individual_id(_state->next_id, _state->id_stream); }
+        
+        //! Returns a new id stream for a subpopulation (see child_individual_id_stream).
+        individual_id_type next_individual_id_stream() {
+            return child_individual_id_stream(next_individual_id(), _state->id_stream);
+        }
+        
+        //! Restart this EA's individual identifiers in the given id stream.
+        void reset_individual_ids(individual_id_type stream) {
+            _state->id_stream = stream;
+            _state->next_id = first_individual_id(stream);
+        }
+        
         //! Returns the current update of this EA.
         unsigned long current_update() { return _state->update; }
         
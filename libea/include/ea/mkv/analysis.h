@@ -281,7 +281,7 @@ namespace ealib {
             datafile df("mkv_dominant_genetic_graph.dot"); // dot file!
             
             std::ostringstream title;
-            title << "name=" << get<IND_UNIQUE_NAME>(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (genetic graph)";
+            title << "name=" << unique_name(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (genetic graph)";
             write_graphviz(title.str(), df, as_genetic_graph(P));
         }
         
@@ -295,7 +295,7 @@ namespace ealib {
             datafile df("mkv_dominant_reduced_graph.dot"); // dot file!
             
             std::ostringstream title;
-            title << "name=" << get<IND_UNIQUE_NAME>(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (reduced graph)";
+            title << "name=" << unique_name(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (reduced graph)";
             write_graphviz(title.str(), df, as_reduced_graph(P));
         }
         
@@ -316,7 +316,7 @@ namespace ealib {
                 datafile df(fname.str());
                 
                 std::ostringstream title;
-                title << "name=" << get<IND_UNIQUE_NAME>(*ind) << ", gen=" << get<IND_GENERATION>(*ind) << " (reduced graph)";
+                title << "name=" << unique_name(*ind) << ", gen=" << get<IND_GENERATION>(*ind) << " (reduced graph)";
                 write_graphviz(title.str(), df, as_reduced_graph(P));
             }
         }
@@ -331,7 +331,7 @@ namespace ealib {
             datafile df("mkv_dominant_causal_graph.dot"); // dot file!
             
             std::ostringstream title;
-            title << "name=" << get<IND_UNIQUE_NAME>(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (causal graph)";
+            title << "name=" << unique_name(*i) << ", gen=" << get<IND_GENERATION>(*i) << " (causal graph)";
             write_graphviz(title.str(), df, as_causal_graph(P));
         }
         
@@ -20,6 +20,10 @@
 #ifndef _EA_MUTATION_H_
 #define _EA_MUTATION_H_
 
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <boost/math/special_functions/log1p.hpp>
 #include <ea/algorithm.h>
 #include <ea/concepts.h>
 #include <ea/metadata.h>
@@ -97,6 +101,46 @@ namespace ealib {
 	}
 
     namespace mutation {
+        
+        /*! Samples the gaps between sites that are each selected independently
+         with probability p.
+         
+         Each call returns the number of unselected sites before the next
+         selected site, which is geometrically distributed:  
+         P(k) = (1-p)^k p.  Skipping ahead by this amount and then selecting a
+         site is thus equivalent to testing each site in turn with probability p,
+         but requires only one random number per selected site.
+         */
+        struct geometric_skip {
+            //! Constructor; if p<=0 no site is ever selected, and if p>=1 every site is.
+            geometric_skip(double p) : _lq(0.0) {
+                if(p >= 1.0) {
+                    _lq = -std::numeric_limits<double>::infinity();
+                } else if(p > 0.0) {
+                    // log1p is accurate for the small p typical of mutation rates:
+                    _lq = boost::math::log1p(-p);
+                }
+            }
+            
+            //! Returns the next gap, saturating at the maximum value of std::size_t.
+            template <typename RNG>
+            std::size_t operator()(RNG& rng) {
+                const std::size_t max_skip=std::numeric_limits<std::size_t>::max();
+                if(_lq == 0.0) {
+                    return max_skip; // p<=0
+                }
+                // 1-U is in (0,1], which keeps log finite:
+                double skip = std::floor(std::log(1.0 - rng.p()) / _lq);
+                // check before converting, since casting a value that does not
+                // fit (or is not a number) to an integer is undefined:
+                if(!(skip < static_cast<double>(max_skip))) {
+                    return max_skip;
+                }
+                return static_cast<std::size_t>(skip);
+            }
+            
+            double _lq; //!< log(1-p); 0 if p<=0, and -inf if p>=1.
+        };
 
         /*! Functors in the mutation::site namespace are site-specific mutation 
          types.  They are meant to be applied on a single site by a mutation 
@@ -153,7 +197,8 @@ namespace ealib {
                 template <typename Iterator, typename EA>
                 void operator()(Iterator i, EA& ea) {
                     _mt(i, ea);
-                    *i = algorithm::clip(*i, get<MUTATION_CLIP_MIN>(ea), get<MUTATION_CLIP_MAX>(ea));
+                    typename std::iterator_traits<Iterator>::value_type v=*i;
+                    *i = algorithm::clip(v, get<MUTATION_CLIP_MIN>(ea), get<MUTATION_CLIP_MAX>(ea));
                 }
                 
                 mutation_type _mt;
@@ -306,6 +351,57 @@ namespace ealib {
             };
             
             
+            /*! Per-site mutation via geometric skipping.
+             
+             Each site is mutated independently with probability 
+             MUTATION_PER_SITE_P, exactly as with per_site, and so the realized
+             mutations have the same distribution.  However, rather than drawing a
+             random number for every site, the distance to the next mutated site
+             is drawn from a geometric distribution (see geometric_skip), so the
+             cost is proportional to the number of mutations rather than to the
+             size of the genome.  This is much faster for large genomes and low
+             mutation rates.
+             
+             Note that this consumes random numbers differently than per_site, and
+             so will not reproduce the same trajectory for a given seed.
+             */
+            template <typename MutationType>
+            struct geometric_per_site {
+                typedef MutationType mutation_type;
+                
+                //! Mutate the sites selected by geometric skipping.
+                template <typename EA>
+                void operator()(typename EA::individual_type& ind, EA& ea) {
+                    typename EA::genome_type& g=ind.genome();
+                    const double per_site_p=get<MUTATION_PER_SITE_P>(ea);
+                    if(per_site_p <= 0.0) {
+                        return;
+                    } else if(per_site_p >= 1.0) {
+                        for(typename EA::genome_type::iterator i=g.begin(); i!=g.end(); ++i) {
+                            _mt(i, ea);
+                        }
+                        return;
+                    }
+                    
+                    geometric_skip skip(per_site_p);
+                    typename EA::genome_type::iterator i=g.begin();
+                    std::size_t remaining=g.size();
+                    for(;;) {
+                        std::size_t k=skip(ea.rng());
+                        if(k >= remaining) {
+                            break;
+                        }
+                        std::advance(i, k);
+                        _mt(i, ea);
+                        ++i;
+                        remaining -= k+1;
+                    }
+                }
+                
+                mutation_type _mt;
+            };
+            
+            
             /*! Insertion/deletion mutation operator.
              
              Inserts a random-sized copy of an existing portion of the genome, or
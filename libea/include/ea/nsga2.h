@@ -22,6 +22,8 @@
 
 #include <boost/serialization/nvp.hpp>
 #include <algorithm>
+#include <limits>
+#include <vector>
 
 #include <ea/algorithm.h>
 #include <ea/individual.h>
@@ -53,10 +55,9 @@ namespace ealib {
     template <typename T>
     struct nsga2_traits : fitness_trait<T> {
         typedef fitness_trait<T> parent;
-        typedef std::vector<typename T::individual_ptr_type> dominated_population_type;
         
         //! Constructor.
-        nsga2_traits() : n(0), rank(0), distance(0.0) {
+        nsga2_traits() : rank(0), distance(0.0) {
         }
 
         //! Serialization.
@@ -65,8 +66,6 @@ namespace ealib {
             ar & boost::serialization::make_nvp("fitness_trait", boost::serialization::base_object<parent>(*this));
         }
         
-        dominated_population_type S; //!< Population of individuals that are dominated by this individual.
-        int n; //!< Number of individuals dominating this individual.
         int rank; //!< Rank of this individual.
         double distance; //<! Crowding distance.
     };
@@ -96,9 +95,143 @@ namespace ealib {
         EA& _ea; //!< Reference to the EA in which the individuals to be compared reside.
     };
     
+    namespace detail {
+        
+        //! Returns the value of a maximized objective, oriented so that larger is better.
+        template <typename T>
+        double oriented_objective(const T& v, maximizeS) { return static_cast<double>(v); }
+        
+        //! Returns the value of a minimized objective, oriented so that larger is better.
+        template <typename T>
+        double oriented_objective(const T& v, minimizeS) { return -static_cast<double>(v); }
+        
+        /*! Returns true if the M objectives starting at a dominate the M
+         objectives starting at b (see algorithm::dominates).
+         */
+        inline bool dominates(const double* a, const double* b, std::size_t M) {
+            bool any=false;
+            for(std::size_t i=0; i<M; ++i) {
+                if(a[i] < b[i]) {
+                    return false;
+                }
+                any = any || (a[i] > b[i]);
+            }
+            return any;
+        }
+        
+        //! Orders rows of a row-major objective matrix lexicographically, greatest first.
+        struct lexicographically_greater {
+            lexicographically_greater(const std::vector<double>& F, std::size_t M) : _F(F), _M(M) {
+            }
+            
+            bool operator()(std::size_t a, std::size_t b) const {
+                const double* pa=&_F[a*_M];
+                const double* pb=&_F[b*_M];
+                return std::lexicographical_compare(pb, pb+_M, pa, pa+_M);
+            }
+            
+            const std::vector<double>& _F;
+            std::size_t _M;
+        };
+        
+        //! Orders rows of a row-major objective matrix by a single objective, least first.
+        struct objective_less {
+            objective_less(const std::vector<double>& F, std::size_t M, std::size_t m) : _F(F), _M(M), _m(m) {
+            }
+            
+            bool operator()(std::size_t a, std::size_t b) const {
+                return _F[a*_M+_m] < _F[b*_M+_m];
+            }
+            
+            const std::vector<double>& _F;
+            std::size_t _M, _m;
+        };
+        
+        //! Returns true if row s of F is dominated by any row in front f.
+        inline bool dominated_by(const std::vector<std::size_t>& f, std::size_t s, const std::vector<double>& F, std::size_t M) {
+            // the most recently added members are the most similar to s:
+            for(std::vector<std::size_t>::const_reverse_iterator i=f.rbegin(); i!=f.rend(); ++i) {
+                if(dominates(&F[(*i)*M], &F[s*M], M)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+        /*! Efficient non-dominated sort with binary search (ENS-BS; Zhang et
+         al., 2015) of the rows of the row-major, N x M objective matrix F.
+         
+         Rows are visited in decreasing lexicographic order, so that no row can
+         be dominated by a row visited after it.  Each row is then placed in the
+         first front that contains no row dominating it.  Since a row dominated
+         by a member of front k is also dominated by a member of every front
+         before k, that front can be found by binary search.  Each row is thus
+         only compared against a few fronts, rather than against the entire
+         population.
+         
+         On return, fronts[i] contains the row indices in the i'th front.
+         */
+        inline void nondominated_sort(const std::vector<double>& F, std::size_t M, std::vector<std::vector<std::size_t> >& fronts) {
+            std::size_t N = (M == 0) ? 0 : (F.size() / M);
+            std::vector<std::size_t> order(N);
+            for(std::size_t i=0; i<N; ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), lexicographically_greater(F,M));
+            
+            fronts.clear();
+            for(std::size_t i=0; i<N; ++i) {
+                std::size_t s=order[i];
+                std::size_t lo=0, hi=fronts.size();
+                while(lo < hi) {
+                    std::size_t mid=(lo+hi)/2;
+                    if(dominated_by(fronts[mid], s, F, M)) {
+                        lo = mid+1;
+                    } else {
+                        hi = mid;
+                    }
+                }
+                if(lo == fronts.size()) {
+                    fronts.push_back(std::vector<std::size_t>());
+                }
+                fronts[lo].push_back(s);
+            }
+        }
+        
+        /*! Calculates the crowding distance D[i] of each row i in front I of
+         the row-major objective matrix F; range[m] is the range of objective m.
+         */
+        inline void crowding_distance(std::vector<std::size_t>& I, const std::vector<double>& F, std::size_t M,
+                                      const std::vector<double>& range, std::vector<double>& D) {
+            if(I.empty()) {
+                return;
+            }
+            for(std::size_t i=0; i<I.size(); ++i) {
+                D[I[i]] = 0.0;
+            }
+            
+            for(std::size_t m=0; m<M; ++m) {
+                std::sort(I.begin(), I.end(), objective_less(F,M,m));
+                
+                D[I.front()] = std::numeric_limits<double>::max();
+                D[I.back()] = std::numeric_limits<double>::max();
+                
+                for(std::size_t i=1; i<(I.size()-1); ++i) {
+                    D[I[i]] += (F[I[i+1]*M+m] - F[I[i-1]*M+m]) / range[m];
+                }
+            }
+        }
+        
+    } // detail
+    
     namespace selection {
         
         /*! NSGA2 selection strategy.
+         
+         Objectives are copied once into a contiguous N x M matrix (oriented so
+         that larger is better), and both non-dominated sorting and crowding
+         distance operate on that matrix and on row indices, rather than on
+         individuals.
          */
         struct nsga2 {
             
@@ -113,82 +246,95 @@ namespace ealib {
                 return algorithm::dominates(ealib::fitness(a,ea), ealib::fitness(b,ea));
             }
             
+            //! Copy the objectives of population P into the row-major matrix F.
+            template <typename Population, typename EA>
+            void objectives(Population& P, std::vector<double>& F, EA& ea) {
+                typedef typename EA::fitness_type::objective_type objective_type;
+                std::size_t M = ea.fitness_function().size();
+                F.resize(P.size() * M);
+                for(std::size_t i=0; i<P.size(); ++i) {
+                    typename EA::fitness_type& f=ealib::fitness(*P[i],ea);
+                    for(std::size_t m=0; m<M; ++m) {
+                        F[i*M+m] = detail::oriented_objective(f[m]._f, typename objective_type::direction_tag());
+                    }
+                }
+            }
+            
             //! Calculates crowding distance among individuals in population I.
             template <typename Population, typename EA>
             void crowding_distance(Population& I, EA& ea) {
-                for(typename Population::iterator i=I.begin(); i!=I.end(); ++i) {
-                    (*i)->traits().distance = 0.0;
-                }
-                
+                std::vector<double> F;
+                objectives(I, F, ea);
                 std::size_t M = ea.fitness_function().size();
-                
+                std::vector<double> range(M), D(I.size());
                 for(std::size_t m=0; m<M; ++m) {
-                    std::sort(I.begin(), I.end(), comparators::objective<EA>(m,ea));
-                    
-                    (*I.begin())->traits().distance = std::numeric_limits<double>::max();
-                    (*I.rbegin())->traits().distance = std::numeric_limits<double>::max();
-                    
-                    for(std::size_t i=1; i<(I.size()-1); ++i) {
-                        I[i]->traits().distance += (ealib::fitness(*I[i+1],ea)[m] - ealib::fitness(*I[i-1],ea)[m]) / ea.fitness_function().range(m);
-                    }
+                    range[m] = ea.fitness_function().range(m);
+                }
+                std::vector<std::size_t> idx(I.size());
+                for(std::size_t i=0; i<I.size(); ++i) {
+                    idx[i] = i;
+                }
+                detail::crowding_distance(idx, F, M, range, D);
+                for(std::size_t i=0; i<I.size(); ++i) {
+                    I[i]->traits().distance = D[i];
                 }
             }
             
-            //! Sort at least n individuals from population P into fronts F.
+            /*! Sort population P into fronts F, assigning rank to each individual.
+             
+             All of P is sorted; n is retained for compatibility.
+             */
             template <typename Population, typename PopulationMap, typename EA>
             void nondominated_sort(Population& P, std::size_t n, PopulationMap& F, EA& ea) {
-                for(typename Population::iterator p=P.begin(); p!=P.end(); ++p) {
-                    (*p)->traits().S.clear();
-                    (*p)->traits().n = 0;
-                    
-                    for(typename Population::iterator q=P.begin(); q!=P.end(); ++q) {
-                        if(p!=q) {
-                            if(dominates(**p,**q,ea)) {
-                                (*p)->traits().S.push_back(*q);
-                            } else if(dominates(**q,**p,ea)) {
-                                ++(*p)->traits().n;
-                            } else {
-                                // p may == q;
-                            }
-                        }
-                    }
-                    if((*p)->traits().n == 0) {
-                        (*p)->traits().rank = 0;
-                        F[0].push_back(*p);
-                    }
-                }
+                std::vector<double> O;
+                objectives(P, O, ea);
+                std::vector<std::vector<std::size_t> > fronts;
+                detail::nondominated_sort(O, ea.fitness_function().size(), fronts);
                 
-                std::size_t i=0;
-                while((!F[i].empty()) && (n>0)) {
-                    Population Q;
-                    for(typename Population::iterator p=F[i].begin(); p!=F[i].end(); ++p) {
-                        for(typename Population::iterator q=(*p)->traits().S.begin(); q!=(*p)->traits().S.end(); ++q) {
-                            --(*q)->traits().n;
-                            if((*q)->traits().n == 0) {
-                                (*q)->traits().rank = i+1;
-                                Q.push_back(*q);
-                            }
-                        }
+                for(std::size_t i=0; i<fronts.size(); ++i) {
+                    Population& f=F[i];
+                    for(std::size_t j=0; j<fronts[i].size(); ++j) {
+                        P[fronts[i][j]]->traits().rank = i;
+                        f.push_back(P[fronts[i][j]]);
                     }
-                    ++i;
-                    n -= Q.size();
-                    std::swap(F[i], Q);
                 }
             }
             
-			//! Select n individuals via tournament selection.
+			//! Select n individuals via non-dominated sorting and crowding distance.
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
                 // build up the fronts:
-                std::map<int,Population> F;
-                nondominated_sort(src, n, F, ea);
-
-                for(std::size_t i=0; (i<F.size()) && (dst.size()<n); ++i) {
-                    crowding_distance(F[i],ea);
-                    std::sort(F[i].begin(), F[i].end(), crowding_comparator<access::traits,EA>(ea));
+                std::size_t M = ea.fitness_function().size();
+                std::vector<double> F;
+                objectives(src, F, ea);
+                std::vector<std::vector<std::size_t> > fronts;
+                detail::nondominated_sort(F, M, fronts);
+                
+                std::vector<double> range(M), D(src.size(), 0.0);
+                for(std::size_t m=0; m<M; ++m) {
+                    range[m] = ea.fitness_function().range(m);
+                }
+                
+                for(std::size_t i=0; i<fronts.size(); ++i) {
+                    for(std::size_t j=0; j<fronts[i].size(); ++j) {
+                        src[fronts[i][j]]->traits().rank = i;
+                    }
+                }
+                
+                for(std::size_t i=0; (i<fronts.size()) && (dst.size()<n); ++i) {
+                    std::vector<std::size_t>& I=fronts[i];
+                    detail::crowding_distance(I, F, M, range, D);
+                    
+                    Population f;
+                    f.reserve(I.size());
+                    for(std::size_t j=0; j<I.size(); ++j) {
+                        src[I[j]]->traits().distance = D[I[j]];
+                        f.push_back(src[I[j]]);
+                    }
+                    std::sort(f.begin(), f.end(), crowding_comparator<access::traits,EA>(ea));
                     dst.insert(dst.end(),
-                               F[i].rbegin(), // start from **greatest** crowding distance
-                               F[i].rbegin() + std::min(F[i].size(), (n-dst.size())));
+                               f.rbegin(), // start from **greatest** crowding distance
+                               f.rbegin() + std::min(f.size(), (n-dst.size())));
                 }
             }
         };
@@ -202,7 +348,8 @@ namespace ealib {
          optimization algorithm EA~\cite{deb}.  It is comprised of three parts (below),
          and then the algorithm itself.
 		 
-         Fast non-dominated sort:
+         Fast non-dominated sort (shown here as originally described; selection::nsga2
+         uses the equivalent, but faster, detail::nondominated_sort):
          P = population, F = fronts
          S_p = solutions dominated by p
          n_p = # of solutions dominating p
@@ -0,0 +1,145 @@
+/* pooled_individual.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_POOLED_INDIVIDUAL_H_
+#define _EA_POOLED_INDIVIDUAL_H_
+
+#include <new>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/pool/singleton_pool.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace ealib {
+    
+    //! Selector for individuals allocated via new and held by boost::shared_ptr (the default).
+    struct shared_individualS { };
+    
+    //! Selector for individuals allocated from a pool and held by boost::intrusive_ptr.
+    struct pooled_individualS { };
+    
+    /*! Individual that is allocated from a pool and reference counted intrusively.
+     
+     Storage for all pooled_individuals of the same type is drawn from (and
+     returned to) a single pool, so that the storage of dead individuals is
+     recycled for offspring instead of going through malloc/free.  The reference
+     count is embedded in the individual, and is deliberately *not* atomic:
+     pointers to the same individual must not be copied or released concurrently
+     from different threads.  Allocation itself is thread-safe.
+     
+     Because boost::intrusive_ptr has no use_count(), pooled individuals cannot
+     be used with line of descent tracking.
+     */
+    template <typename Individual>
+    class pooled_individual : public Individual {
+    public:
+        typedef Individual base_type;
+        
+        //! Constructor.
+        pooled_individual() : _refcount(0) {
+        }
+        
+        //! Constructor that forwards to the underlying individual (e.g., from a genome).
+        template <typename T>
+        explicit pooled_individual(const T& t) : base_type(t), _refcount(0) {
+        }
+        
+        //! Copy constructor; the copy is unreferenced.
+        pooled_individual(const pooled_individual& that) : base_type(that), _refcount(0) {
+        }
+        
+        //! Assignment operator; references to this individual are unchanged.
+        pooled_individual& operator=(const pooled_individual& that) {
+            base_type::operator=(that);
+            return *this;
+        }
+        
+        //! Allocate storage for a pooled individual.
+        static void* operator new(std::size_t n) {
+            if(n != sizeof(pooled_individual)) {
+                return ::operator new(n);
+            }
+            void* p=boost::singleton_pool<pooled_individual, sizeof(pooled_individual)>::malloc();
+            if(p == 0) {
+                throw std::bad_alloc();
+            }
+            return p;
+        }
+        
+        //! Return the storage of a dead pooled individual to the pool.
+        static void operator delete(void* p, std::size_t n) {
+            if(p == 0) {
+                return;
+            }
+            if(n != sizeof(pooled_individual)) {
+                ::operator delete(p);
+                return;
+            }
+            boost::singleton_pool<pooled_individual, sizeof(pooled_individual)>::free(p);
+        }
+        
+        //! Increment the reference count of p.
+        friend void intrusive_ptr_add_ref(pooled_individual* p) {
+            ++p->_refcount;
+        }
+        
+        //! Decrement the reference count of p, deleting it when it is unreferenced.
+        friend void intrusive_ptr_release(pooled_individual* p) {
+            if(--p->_refcount == 0) {
+                delete p;
+            }
+        }
+        
+    protected:
+        std::size_t _refcount; //!< Number of pointers to this individual.
+        
+    private:
+        friend class boost::serialization::access;
+        
+        //! Serialize this individual exactly as the underlying individual.
+        template <class Archive>
+        void serialize(Archive& ar, const unsigned int version) {
+            boost::serialization::serialize_adl(ar, static_cast<base_type&>(*this), version);
+        }
+    };
+    
+    /*! Selects the type of individual and pointer used by an EA for the given
+     storage selector.
+     */
+    template <typename Individual, typename StorageSelector>
+    struct individual_storage {
+    };
+    
+    //! Individuals allocated via new and held by boost::shared_ptr.
+    template <typename Individual>
+    struct individual_storage<Individual, shared_individualS> {
+        typedef Individual individual_type;
+        typedef boost::shared_ptr<individual_type> pointer_type;
+    };
+    
+    //! Individuals allocated from a pool and held by boost::intrusive_ptr.
+    template <typename Individual>
+    struct individual_storage<Individual, pooled_individualS> {
+        typedef pooled_individual<Individual> individual_type;
+        typedef boost::intrusive_ptr<individual_type> pointer_type;
+    };
+    
+} // ealib
+
+#endif
@@ -27,11 +27,21 @@
 
 namespace ealib {
     
+    /*! Swap the n elements starting at a[i] with the n elements starting at b[j].
+     
+     Genome types with a packed representation (e.g., packed_bitstring) overload
+     this to swap entire words at a time.
+     */
+    template <typename Sequence>
+    void swap_ranges(Sequence& a, std::size_t i, Sequence& b, std::size_t j, std::size_t n) {
+        std::swap_ranges(a.begin()+i, a.begin()+i+n, b.begin()+j);
+    }
+    
     /*! Common inheritance details.
      */
     template <typename EA>
     void inherits_from(typename EA::individual_type& parent, typename EA::individual_type& offspring, EA& ea) {
-		put<IND_UNIQUE_NAME>(ea.rng().uuid(), offspring);
+        offspring.id() = ea.next_individual_id();
         put<IND_GENERATION>(get<IND_GENERATION>(parent)+1.0, offspring);
         put<IND_BIRTH_UPDATE>(ea.current_update(), offspring);
     }
@@ -159,7 +169,7 @@ namespace ealib {
                 std::size_t xover = ea.rng()(o1.size());
                 
                 // and swap [begin,xover) between o1 and o2:
-                std::swap_ranges(o1.begin(), o1.begin()+xover, o2.begin());
+                swap_ranges(o1, 0, o2, 0, xover);
                 
                 // output the individuals:
                 offspring.insert(offspring.end(), ea.make_individual(o1));
@@ -191,7 +201,7 @@ namespace ealib {
                 std::size_t x2=ea.rng()(0, o2.size()-e);
                 
                 // swap 'em:
-                std::swap_ranges(o1.begin()+x1, o1.begin()+x1+e, o2.begin()+x2);
+                swap_ranges(o1, x1, o2, x2, e);
                 
                 // output the individuals:
                 offspring.insert(offspring.end(), ea.make_individual(o1));
@@ -38,6 +38,7 @@
 
 #include <ea/algorithm.h>
 #include <ea/metadata.h>
+#include <ea/rng_engines.h>
 
 
 namespace ealib {
@@ -46,10 +47,14 @@ namespace ealib {
 
 	/*! Provides useful abstractions for dealing with random numbers.
 	 
-	 Note: when many random numbers are needed, consider using the uniform_X_rng
-	 methods.  These methods return a generator that can be quickly queried for new 
-	 random numbers, as opposed to the uniform_X methods, that build a new generator 
-	 and use it once for each call.
+	 The Engine may be any Boost UniformRandomNumberGenerator that can be
+	 written to and read from a stream, e.g., boost::mt19937 (the default), or
+	 one of xoshiro256ss, pcg64, or philox4x32 (see rng_engines.h).
+	 
+	 Distributions are applied directly to the engine, rather than through a
+	 new generator object for each call.  When many random numbers are needed,
+	 consider using the fill_X methods, which write them into a caller-supplied
+	 range.
 	 */
 	template <typename Engine>
 	class rng {
@@ -80,29 +85,28 @@ namespace ealib {
 		typedef int result_type;
 
 		//! Constructor.
-		rng() {
+		rng() : _p(0.0,1.0), _bit(0,1) {
 			reset(static_cast<unsigned int>(std::time(0)));
 		}
 		
 		//! Constructor with specified rng seed.
-		rng(unsigned int s) {
+		rng(unsigned int s) : _p(0.0,1.0), _bit(0,1) {
 			reset(s);
 		}
+        
+        //! Constructor from an engine in a given state.
+        explicit rng(const engine_type& e) : _eng(e), _p(0.0,1.0), _bit(0,1) {
+        }
 		
         //! Copy constructor.
-		rng(const rng& that) : _eng(that._eng) {
-            _p.reset(new real_rng_type(_eng, uniform_real_dist(0.0,1.0)));
-			_bit.reset(new int_rng_type(_eng, uniform_int_dist(0,1)));
-			_uuid.reset(new uuid_generator_type(_eng));
+		rng(const rng& that) : _eng(that._eng), _p(0.0,1.0), _bit(0,1) {
         }
         
 		//! Assignment operator.
 		rng& operator=(const rng& that) {
             if(this != &that) {
                 _eng = that._eng;
-                _p.reset(new real_rng_type(_eng, uniform_real_dist(0.0,1.0)));
-                _bit.reset(new int_rng_type(_eng, uniform_int_dist(0,1)));
-				_uuid.reset(new uuid_generator_type(_eng));
+				_uuid.reset();
 			}
             return *this;
         }		
@@ -112,16 +116,20 @@ namespace ealib {
             return _eng == that._eng;
         }
         
-		//! Reset this random number generator with the specified seed.
-		void reset(unsigned int s) {
+		/*! Reset this random number generator with the specified seed, or from
+         the clock if s is 0; returns the seed that was used.
+         */
+		unsigned int reset(unsigned int s) {
 			if(s == 0) {
 				s = static_cast<unsigned int>(std::time(0));
 			}
 			_eng.seed(s);
-			_p.reset(new real_rng_type(_eng, uniform_real_dist(0.0,1.0)));
-			_bit.reset(new int_rng_type(_eng, uniform_int_dist(0,1)));
-			_uuid.reset(new uuid_generator_type(_eng));
+			_uuid.reset();
+            return s;
 		}
+        
+        //! Returns this rng's engine.
+        engine_type& engine() { return _eng; }
 		
 		/*! Returns a random number in the range [0,n).
 		 
@@ -129,7 +137,7 @@ namespace ealib {
          STL algorithms.
 		 */
 		result_type operator()(argument_type n) {
-			return uniform_integer_rng(0,n)();
+			return uniform_int_dist(0,n-1)(_eng);
 		}
 
         /*! Returns a random number in the range [l,u).
@@ -138,35 +146,35 @@ namespace ealib {
          STL algorithms.
 		 */
 		result_type operator()(argument_type l, argument_type u) {
-			return uniform_integer_rng(l,u)();
+			return uniform_int_dist(l,u-1)(_eng);
 		}
 
 		/*! Returns a random number in the range [0,maxint).
          */
         result_type operator()() {
-			return uniform_integer_rng(0,std::numeric_limits<argument_type>::max())();
+			return uniform_int_dist(0,std::numeric_limits<argument_type>::max()-1)(_eng);
 		}
 
         /*! Returns a random number in the range [1,maxint-1), suitable for generation of random number seeds.
          */
         result_type seed() {
-            return 1 + uniform_integer_rng(0,std::numeric_limits<argument_type>::max()-1)();
+            return 1 + uniform_int_dist(0,std::numeric_limits<argument_type>::max()-2)(_eng);
 		}
 
 		/*! Test a probability.
 		 
 		 Returns true if P < prob, false if P >= prob.  Prob must be in the range [0,1].
 		 */
-		bool p(double prob) { assert((prob >= 0.0) && (prob <= 1.0)); return (*_p)() < prob; }
+		bool p(double prob) { assert((prob >= 0.0) && (prob <= 1.0)); return _p(_eng) < prob; }
 
         //! Returns a probability.
-        double p() { return (*_p)(); }
+        double p() { return _p(_eng); }
         
 		//! Returns a random bit.
-		bool bit() { return (*_bit)(); }
+		bool bit() { return _bit(_eng); }
 		
 		//! Returns a random real value uniformly drawn from the range [min, max) 
-		double uniform_real(double min, double max) { return uniform_real_rng(min,max)(); }
+		double uniform_real(double min, double max) { return uniform_real_dist(min,max)(_eng); }
 
 		//! Returns a random real value uniformly drawn from the range (min, max).
 		double uniform_real_nz(double min, double max) {
@@ -184,7 +192,7 @@ namespace ealib {
 
 		//! Returns a random real value drawn from a normal distribution with the given mean and variance.
 		double normal_real(double mean, double variance) {
-			return normal_real_rng_type(_eng, normal_real_dist(mean, variance))();
+			return normal_real_dist(mean, variance)(_eng);
 		}
         
 		//! Returns a generator of random real values drawn from a normal distribution with the given mean and variance.
@@ -197,7 +205,7 @@ namespace ealib {
 		 For consistency with most other random number generators, max will never be
 		 returned.
 		 */
-		int uniform_integer(int min, int max) { return uniform_integer_rng(min,max)(); }
+		int uniform_integer(int min, int max) { return uniform_int_dist(min,max-1)(_eng); }
 		
         /*! Returns a random integer.
          */
@@ -212,6 +220,46 @@ namespace ealib {
 			return int_rng_type(_eng, uniform_int_dist(min,max-1));
 		}
 
+        /*! Fill [f,l) with random real values uniformly drawn from the range [min, max).
+         
+         The values written are the same as would be returned by successive
+         calls to uniform_real(min, max).
+         */
+        template <typename ForwardIterator>
+        void fill_uniform(ForwardIterator f, ForwardIterator l, double min=0.0, double max=1.0) {
+            uniform_real_dist d(min,max);
+            for( ; f!=l; ++f) {
+                *f = d(_eng);
+            }
+        }
+        
+        /*! Fill [f,l) with the results of Bernoulli trials with probability prob.
+         
+         The values written are the same as would be returned by successive
+         calls to p(prob).
+         */
+        template <typename ForwardIterator>
+        void fill_bernoulli(ForwardIterator f, ForwardIterator l, double prob) {
+            assert((prob >= 0.0) && (prob <= 1.0));
+            for( ; f!=l; ++f) {
+                *f = (_p(_eng) < prob);
+            }
+        }
+        
+        /*! Fill [f,l) with random real values drawn from a normal distribution
+         with the given mean and variance.
+         
+         The values written are the same as would be returned by successive
+         calls to normal_real(mean, variance).
+         */
+        template <typename ForwardIterator>
+        void fill_normal(ForwardIterator f, ForwardIterator l, double mean, double variance) {
+            normal_real_dist d(mean, variance);
+            for( ; f!=l; ++f) {
+                *f = d(_eng);
+            }
+        }
+        
         /*! Generates random numbers into the given output iterator.
          */
         template <typename T, typename OutputIterator>
@@ -334,14 +382,17 @@ namespace ealib {
 		
 		//! Returns a random UUID in string format.
 		std::string uuid() {
+            if(!_uuid) {
+                _uuid.reset(new uuid_generator_type(_eng));
+            }
 			return boost::lexical_cast<std::string>((*_uuid)());
 		}
 
 	private:
 		engine_type _eng; //!< Underlying generator of randomness.
-		boost::scoped_ptr<real_rng_type> _p; //!< Generator for probabilities.
-		boost::scoped_ptr<int_rng_type> _bit; //!< Generator for bits.
-		boost::scoped_ptr<uuid_generator_type> _uuid; //!< Generator for UUIDs.
+		uniform_real_dist _p; //!< Distribution of probabilities.
+		uniform_int_dist _bit; //!< Distribution of bits.
+		boost::scoped_ptr<uuid_generator_type> _uuid; //!< Generator for UUIDs (built on first use).
 
 		// These enable serialization and de-serialization of the rng state.
 		friend class boost::serialization::access;
@@ -395,6 +446,83 @@ namespace ealib {
 
 	//! Default random number generation type.
 	typedef rng<boost::mt19937> default_rng_type;
+    
+    //! Random number generation type using xoshiro256**.
+    typedef rng<xoshiro256ss> xoshiro_rng_type;
+    
+    //! Random number generation type using PCG64.
+    typedef rng<pcg64> pcg_rng_type;
+    
+    //! Random number generation type using Philox4x32-10.
+    typedef rng<philox4x32> philox_rng_type;
+    
+    /*! Counter-based, splittable random number streams.
+     
+     Each stream is a philox_rng_type that is keyed by a master seed and a
+     purpose, and whose counter starts at a position given by an update and an
+     id (e.g., of an individual):
+     
+         key     = (seed, purpose)
+         counter = (0, update, low 32 bits of id, high 32 bits of id)
+     
+     Since Philox is a bijection of the counter for each key, streams for
+     distinct (update, id, purpose) do not overlap unless one of them draws more
+     than 2^34 numbers.  Any stream can be built directly from its key, in any
+     order and on any thread, without locking or consuming a shared rng; the
+     numbers drawn therefore depend only on the master seed and the stream keys,
+     not on the number of threads.  Updates are taken modulo 2^32.
+     
+     The master seed is the only state, and a const rng_streams may be shared
+     freely among threads.
+     */
+    class rng_streams {
+    public:
+        typedef philox_rng_type rng_type; //!< Type of rng for each stream.
+        typedef boost::uint64_t id_type; //!< Type of stream ids.
+        
+        //! Constructor.
+        rng_streams(unsigned int seed=0) : _seed(seed) {
+        }
+        
+        //! Reset the master seed.
+        void reset(unsigned int seed) { _seed = seed; }
+        
+        //! Returns the master seed.
+        unsigned int seed() const { return _seed; }
+        
+        //! Returns the stream for the given update, id, and purpose.
+        rng_type operator()(unsigned long update, id_type id, unsigned int purpose) const {
+            philox4x32 e(_seed, purpose);
+            e.set_counter(0,
+                          static_cast<philox4x32::result_type>(update),
+                          static_cast<philox4x32::result_type>(id),
+                          static_cast<philox4x32::result_type>(id >> 32));
+            return rng_type(e);
+        }
+        
+    private:
+        unsigned int _seed; //!< Master seed.
+        
+		friend class boost::serialization::access;
+        template<class Archive>
+        void serialize(Archive& ar, const unsigned int version) {
+            ar & boost::serialization::make_nvp("seed", _seed);
+        }
+    };
+    
+    /*! Returns the rng stream for the given id and purpose during the EA's
+     current update.
+     
+     Streams are keyed by the EA's RNG_SEED, which is checkpointed along with
+     the rest of its meta-data, so a run that is restored from a checkpoint will
+     see the same streams.  Drawing from a stream does not consume numbers from
+     ea.rng().  To draw streams from several threads, build an rng_streams from
+     RNG_SEED once (on the calling thread) and share it.
+     */
+    template <typename EA>
+    rng_streams::rng_type rng_stream(rng_streams::id_type id, unsigned int purpose, EA& ea) {
+        return rng_streams(get<RNG_SEED>(ea))(ea.current_update(), id, purpose);
+    }
 
 } // util
 
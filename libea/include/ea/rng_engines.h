@@ -0,0 +1,368 @@
+/* rng_engines.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_RNG_ENGINES_H_
+#define _EA_RNG_ENGINES_H_
+
+#include <boost/cstdint.hpp>
+#include <istream>
+#include <ostream>
+
+namespace ealib {
+
+    /* Engines in this file model Boost's UniformRandomNumberGenerator and may be
+     used as the Engine parameter of ealib::rng.  Each can be seeded with a single
+     unsigned int, compared for equality, and written to and read from a stream
+     (which is how ealib::rng serializes its engine).
+     */
+
+    namespace detail {
+
+        //! Returns the next value of a splitmix64 sequence; used to expand seeds.
+        inline boost::uint64_t splitmix64(boost::uint64_t& x) {
+            boost::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        //! Rotate x left by k bits.
+        inline boost::uint64_t rotl64(boost::uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        //! Computes the 128-bit product of a and b.
+        inline void mul64(boost::uint64_t a, boost::uint64_t b, boost::uint64_t& hi, boost::uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+            hi = static_cast<boost::uint64_t>(p >> 64);
+            lo = static_cast<boost::uint64_t>(p);
+#else
+            boost::uint64_t a0=a&0xffffffffULL, a1=a>>32, b0=b&0xffffffffULL, b1=b>>32;
+            boost::uint64_t p00=a0*b0, p01=a0*b1, p10=a1*b0, p11=a1*b1;
+            boost::uint64_t mid=(p00>>32) + (p01&0xffffffffULL) + (p10&0xffffffffULL);
+            hi = p11 + (p01>>32) + (p10>>32) + (mid>>32);
+            lo = (mid<<32) | (p00&0xffffffffULL);
+#endif
+        }
+
+    } // detail
+
+    /*! xoshiro256** (Blackman and Vigna), a small and very fast 64-bit generator
+     with 256 bits of state.
+     */
+    class xoshiro256ss {
+    public:
+        typedef boost::uint64_t result_type;
+        static const bool has_fixed_range = false;
+
+        //! Constructor.
+        xoshiro256ss(unsigned int s=5489u) {
+            seed(s);
+        }
+
+        //! Constructor with explicit state, which must not be all zero.
+        xoshiro256ss(result_type s0, result_type s1, result_type s2, result_type s3) {
+            _s[0] = s0; _s[1] = s1; _s[2] = s2; _s[3] = s3;
+        }
+
+        //! Seed this engine; the seed is expanded to the full state via splitmix64.
+        void seed(unsigned int s=5489u) {
+            boost::uint64_t x=s;
+            for(int i=0; i<4; ++i) {
+                _s[i] = detail::splitmix64(x);
+            }
+        }
+
+        static result_type min() { return 0; }
+        static result_type max() { return ~static_cast<result_type>(0); }
+
+        //! Returns the next random number.
+        result_type operator()() {
+            const result_type r = detail::rotl64(_s[1]*5, 7) * 9;
+            const result_type t = _s[1] << 17;
+            _s[2] ^= _s[0];
+            _s[3] ^= _s[1];
+            _s[1] ^= _s[2];
+            _s[0] ^= _s[3];
+            _s[2] ^= t;
+            _s[3] = detail::rotl64(_s[3], 45);
+            return r;
+        }
+
+        //! Discard the next n random numbers.
+        void discard(boost::uintmax_t n) {
+            for( ; n>0; --n) {
+                (*this)();
+            }
+        }
+
+        friend bool operator==(const xoshiro256ss& a, const xoshiro256ss& b) {
+            return (a._s[0] == b._s[0]) && (a._s[1] == b._s[1]) && (a._s[2] == b._s[2]) && (a._s[3] == b._s[3]);
+        }
+
+        friend bool operator!=(const xoshiro256ss& a, const xoshiro256ss& b) {
+            return !(a == b);
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_ostream<CharT,Traits>& operator<<(std::basic_ostream<CharT,Traits>& out, const xoshiro256ss& e) {
+            return out << e._s[0] << ' ' << e._s[1] << ' ' << e._s[2] << ' ' << e._s[3];
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_istream<CharT,Traits>& operator>>(std::basic_istream<CharT,Traits>& in, xoshiro256ss& e) {
+            return in >> e._s[0] >> e._s[1] >> e._s[2] >> e._s[3];
+        }
+
+    private:
+        result_type _s[4]; //!< Generator state.
+    };
+
+    /*! PCG64 (O'Neill): a 128-bit linear congruential generator with an
+     xor-shift-low, random-rotate output function (XSL RR 128/64).
+     */
+    class pcg64 {
+    public:
+        typedef boost::uint64_t result_type;
+        static const bool has_fixed_range = false;
+
+        //! Constructor.
+        pcg64(unsigned int s=5489u) {
+            seed(s);
+        }
+
+        //! Constructor with an initial state and stream selector.
+        pcg64(result_type initstate, result_type initseq) {
+            seed(0, initstate, 0, initseq);
+        }
+
+        //! Seed this engine; the seed is expanded to the state and stream via splitmix64.
+        void seed(unsigned int s=5489u) {
+            boost::uint64_t x=s;
+            result_type s1=detail::splitmix64(x), s0=detail::splitmix64(x);
+            result_type q1=detail::splitmix64(x), q0=detail::splitmix64(x);
+            seed(s1, s0, q1, q0);
+        }
+
+        /*! Seed this engine with a 128-bit initial state and stream selector, each
+         given as (high, low) words; equivalent to the reference pcg64 srandom.
+         */
+        void seed(result_type state_hi, result_type state_lo, result_type seq_hi, result_type seq_lo) {
+            _inc_hi = (seq_hi << 1) | (seq_lo >> 63);
+            _inc_lo = (seq_lo << 1) | 1u;
+            _hi = 0; _lo = 0;
+            step();
+            add(state_hi, state_lo);
+            step();
+        }
+
+        static result_type min() { return 0; }
+        static result_type max() { return ~static_cast<result_type>(0); }
+
+        //! Returns the next random number.
+        result_type operator()() {
+            step();
+            const result_type v = _hi ^ _lo;
+            const unsigned int rot = static_cast<unsigned int>(_hi >> 58);
+            return (v >> rot) | (v << ((64u - rot) & 63u));
+        }
+
+        //! Discard the next n random numbers.
+        void discard(boost::uintmax_t n) {
+            for( ; n>0; --n) {
+                step();
+            }
+        }
+
+        friend bool operator==(const pcg64& a, const pcg64& b) {
+            return (a._hi == b._hi) && (a._lo == b._lo) && (a._inc_hi == b._inc_hi) && (a._inc_lo == b._inc_lo);
+        }
+
+        friend bool operator!=(const pcg64& a, const pcg64& b) {
+            return !(a == b);
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_ostream<CharT,Traits>& operator<<(std::basic_ostream<CharT,Traits>& out, const pcg64& e) {
+            return out << e._hi << ' ' << e._lo << ' ' << e._inc_hi << ' ' << e._inc_lo;
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_istream<CharT,Traits>& operator>>(std::basic_istream<CharT,Traits>& in, pcg64& e) {
+            return in >> e._hi >> e._lo >> e._inc_hi >> e._inc_lo;
+        }
+
+    private:
+        //! Adds (hi,lo) to the state.
+        void add(result_type hi, result_type lo) {
+            _lo += lo;
+            _hi += hi + (_lo < lo);
+        }
+
+        //! Advance the LCG: state = state * multiplier + increment (mod 2^128).
+        void step() {
+            const result_type mul_hi=2549297995355413924ULL, mul_lo=4865540595714422341ULL;
+            result_type hi, lo;
+            detail::mul64(_lo, mul_lo, hi, lo);
+            hi += _lo*mul_hi + _hi*mul_lo;
+            _hi = hi; _lo = lo;
+            add(_inc_hi, _inc_lo);
+        }
+
+        result_type _hi, _lo; //!< 128-bit LCG state.
+        result_type _inc_hi, _inc_lo; //!< 128-bit LCG increment (always odd); selects the stream.
+    };
+
+    /*! Philox4x32-10 (Salmon et al.), a counter-based generator.
+
+     Each 128-bit counter value is mapped through a keyed bijection to four 32-bit
+     random numbers, which are then returned in order.  Since any block can be
+     computed directly from (counter, key), this engine can jump to an arbitrary
+     position in its sequence in constant time (see set_counter and block).
+     */
+    class philox4x32 {
+    public:
+        typedef boost::uint32_t result_type;
+        static const bool has_fixed_range = false;
+
+        //! Constructor.
+        philox4x32(unsigned int s=5489u) {
+            seed(s);
+        }
+
+        //! Constructor with explicit key.
+        philox4x32(result_type k0, result_type k1) {
+            seed(k0, k1);
+        }
+
+        //! Seed this engine; the seed is used as the key, and the counter is reset.
+        void seed(unsigned int s=5489u) {
+            seed(s, 0);
+        }
+
+        //! Seed this engine with the given key, and reset the counter.
+        void seed(result_type k0, result_type k1) {
+            _key[0] = k0; _key[1] = k1;
+            set_counter(0, 0, 0, 0);
+        }
+
+        //! Set the counter; the next number returned is the first of block (c0,c1,c2,c3).
+        void set_counter(result_type c0, result_type c1, result_type c2, result_type c3) {
+            _ctr[0] = c0; _ctr[1] = c1; _ctr[2] = c2; _ctr[3] = c3;
+            _idx = 4;
+        }
+
+        static result_type min() { return 0; }
+        static result_type max() { return ~static_cast<result_type>(0); }
+
+        //! Returns the next random number.
+        result_type operator()() {
+            if(_idx == 4) {
+                block(_ctr, _key, _buf);
+                increment();
+                _idx = 0;
+            }
+            return _buf[_idx++];
+        }
+
+        //! Discard the next n random numbers.
+        void discard(boost::uintmax_t n) {
+            for( ; n>0; --n) {
+                (*this)();
+            }
+        }
+
+        //! Compute the four random numbers for counter ctr and key key into out.
+        static void block(const result_type ctr[4], const result_type key[2], result_type out[4]) {
+            result_type c0=ctr[0], c1=ctr[1], c2=ctr[2], c3=ctr[3];
+            result_type k0=key[0], k1=key[1];
+            for(int r=0; r<10; ++r) {
+                if(r > 0) {
+                    k0 += 0x9E3779B9u;
+                    k1 += 0xBB67AE85u;
+                }
+                const boost::uint64_t p0 = static_cast<boost::uint64_t>(0xD2511F53u) * c0;
+                const boost::uint64_t p1 = static_cast<boost::uint64_t>(0xCD9E8D57u) * c2;
+                const result_type hi0=static_cast<result_type>(p0>>32), lo0=static_cast<result_type>(p0);
+                const result_type hi1=static_cast<result_type>(p1>>32), lo1=static_cast<result_type>(p1);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = lo1;
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = lo0;
+            }
+            out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+        }
+
+        friend bool operator==(const philox4x32& a, const philox4x32& b) {
+            for(int i=0; i<4; ++i) {
+                if(a._ctr[i] != b._ctr[i]) {
+                    return false;
+                }
+            }
+            return (a._key[0] == b._key[0]) && (a._key[1] == b._key[1]) && (a._idx == b._idx);
+        }
+
+        friend bool operator!=(const philox4x32& a, const philox4x32& b) {
+            return !(a == b);
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_ostream<CharT,Traits>& operator<<(std::basic_ostream<CharT,Traits>& out, const philox4x32& e) {
+            // the buffered block is recomputed on load, so only the counter of
+            // the *next* block and the index into the current block are saved.
+            return out << e._key[0] << ' ' << e._key[1] << ' '
+            << e._ctr[0] << ' ' << e._ctr[1] << ' ' << e._ctr[2] << ' ' << e._ctr[3] << ' ' << e._idx;
+        }
+
+        template <typename CharT, typename Traits>
+        friend std::basic_istream<CharT,Traits>& operator>>(std::basic_istream<CharT,Traits>& in, philox4x32& e) {
+            in >> e._key[0] >> e._key[1] >> e._ctr[0] >> e._ctr[1] >> e._ctr[2] >> e._ctr[3] >> e._idx;
+            if(e._idx < 4) {
+                // recompute the current block from the previous counter value:
+                result_type c[4] = { e._ctr[0], e._ctr[1], e._ctr[2], e._ctr[3] };
+                for(int i=0; i<4; ++i) {
+                    if(c[i]-- != 0) {
+                        break;
+                    }
+                }
+                block(c, e._key, e._buf);
+            }
+            return in;
+        }
+
+    private:
+        //! Increment the 128-bit counter.
+        void increment() {
+            for(int i=0; i<4; ++i) {
+                if(++_ctr[i] != 0) {
+                    break;
+                }
+            }
+        }
+
+        result_type _key[2]; //!< Key.
+        result_type _ctr[4]; //!< Counter of the next block.
+        result_type _buf[4]; //!< Current block.
+        unsigned int _idx; //!< Index of the next number in the current block (4 if exhausted).
+    };
+
+} // ealib
+
+#endif
@@ -20,10 +20,117 @@
 #ifndef _EA_SELECTION_H_
 #define _EA_SELECTION_H_
 
+#include <algorithm>
+#include <vector>
 #include <ea/fitness_function.h>
 
 namespace ealib {
     
+    namespace detail {
+        
+        //! A precomputed attribute of an individual, and its index in the source population.
+        template <typename Key>
+        struct keyed_index {
+            keyed_index(const Key& k, std::size_t i) : key(k), idx(i) {
+            }
+            
+            //! Orders larger keys first; ties are ordered by index.
+            bool operator<(const keyed_index& that) const {
+                if(that.key < key) {
+                    return true;
+                } else if(key < that.key) {
+                    return false;
+                }
+                return idx < that.idx;
+            }
+            
+            Key key; //!< Attribute of the individual.
+            std::size_t idx; //!< Index of the individual in the source population.
+        };
+        
+        //! Orders indices into a population by a comparator, largest first; ties are ordered by index.
+        template <typename Population, typename Comparator>
+        struct greater_by {
+            greater_by(Population& src, Comparator& comp) : _src(src), _comp(comp) {
+            }
+            
+            bool operator()(std::size_t a, std::size_t b) {
+                if(_comp(_src[b], _src[a])) {
+                    return true;
+                } else if(_comp(_src[a], _src[b])) {
+                    return false;
+                }
+                return a < b;
+            }
+            
+            Population& _src;
+            Comparator& _comp;
+        };
+        
+        //! Moves the n smallest elements of [f,l) to its front, in order.
+        template <typename RandomAccessIterator, typename Compare>
+        void top_n(RandomAccessIterator f, RandomAccessIterator l, std::size_t n, Compare comp) {
+            if(static_cast<std::size_t>(l-f) > n) {
+                std::nth_element(f, f+n, l, comp);
+            }
+            std::sort(f, f+std::min(n, static_cast<std::size_t>(l-f)), comp);
+        }
+        
+    } // detail
+    
+    /*! Set idx to the indices of the (at most) n most-fit individuals in src,
+     most-fit first.
+     
+     Each individual's fitness is read once, and ties are broken in favor of
+     the individual that appears first in src.  src is not modified.  Runs in
+     O(N + n log n) time, where N is the size of src.
+     */
+    template <typename Population, typename EA>
+    void top_n_indices(Population& src, std::size_t n, std::vector<std::size_t>& idx, EA& ea) {
+        typedef detail::keyed_index<typename EA::fitness_type> key_type;
+        std::vector<key_type> keys;
+        keys.reserve(src.size());
+        for(std::size_t i=0; i<src.size(); ++i) {
+            keys.push_back(key_type(ealib::fitness(*src[i],ea), i));
+        }
+        detail::top_n(keys.begin(), keys.end(), n, std::less<key_type>());
+        idx.clear();
+        for(std::size_t i=0; i<std::min(n,keys.size()); ++i) {
+            idx.push_back(keys[i].idx);
+        }
+    }
+    
+    /*! Append the (at most) n most-fit individuals in src to dst, most-fit first.
+     
+     See top_n_indices for details on ordering and complexity.
+     */
+    template <typename Population, typename EA>
+    void select_top_n(Population& src, Population& dst, std::size_t n, EA& ea) {
+        std::vector<std::size_t> idx;
+        top_n_indices(src, n, idx, ea);
+        for(std::size_t i=0; i<idx.size(); ++i) {
+            dst.insert(dst.end(), src[idx[i]]);
+        }
+    }
+    
+    /*! Append the (at most) n greatest individuals in src to dst, greatest first,
+     as ordered by comp.
+     
+     Ties are broken in favor of the individual that appears first in src, and
+     src is not modified.  Runs in O(N + n log n) time.
+     */
+    template <typename Population, typename Comparator>
+    void select_top_n_by(Population& src, Population& dst, std::size_t n, Comparator comp) {
+        std::vector<std::size_t> idx(src.size());
+        for(std::size_t i=0; i<idx.size(); ++i) {
+            idx[i] = i;
+        }
+        detail::top_n(idx.begin(), idx.end(), n, detail::greater_by<Population,Comparator>(src, comp));
+        for(std::size_t i=0; i<std::min(n,idx.size()); ++i) {
+            dst.insert(dst.end(), src[idx[i]]);
+        }
+    }
+    
     //! Selector for random with replacement.
     struct with_replacementS { };
     
@@ -21,10 +21,9 @@
 #define _EA_SELECTION_ELITISM_H_
 
 #include <algorithm>
-#include <iterator>
-#include <ea/algorithm.h>
-#include <ea/comparators.h>
+#include <vector>
 #include <ea/metadata.h>
+#include <ea/selection.h>
 
 namespace ealib {
 
@@ -40,6 +39,12 @@ namespace ealib {
 		 (high-fitness) individuals.  Those selected are *still* maintained as part
 		 of the source population from which the embedded selection strategy draws its
 		 own selected individuals.
+         
+         The elite are found in O(N + e log e) time without reordering the source
+         population, and are appended to dst most-fit first; ties are broken in
+         favor of the individual that appears first in the source population.
+         The elite are found anew on every call, since the source population may
+         have changed in between.
 		 */
  		template <typename SelectionStrategy>
 		struct elitism {
@@ -61,13 +66,9 @@ namespace ealib {
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
 				std::size_t e = get<ELITISM_N>(ea);
                 assert(n > e);
+                std::size_t first = append_elite(src, dst, e, ea);
                 _embedded(src, dst, n-e, ea);
-                
-                // now, append the e most-fit individuals:
-                if(e > 0) {
-                    std::sort(src.begin(), src.end(), comparators::fitness<EA>(ea));
-                    algorithm::copy_n(src.rbegin(), e, std::inserter(dst,dst.end()));
-                }
+                std::rotate(dst.begin()+first, dst.begin()+first+_elite.size(), dst.end());
             }
             
             /*! Preserve the elite individuals from the src population.
@@ -75,17 +76,30 @@ namespace ealib {
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, EA& ea) {
 				std::size_t e = get<ELITISM_N>(ea);
+                std::size_t first = append_elite(src, dst, e, ea);
                 _embedded(src, dst, ea);
-                
-                // now, append the e most-fit individuals:
-                if(e > 0) {
-                    std::sort(src.begin(), src.end(), comparators::fitness<EA>(ea));
-                    algorithm::copy_n(src.rbegin(), e, std::inserter(dst,dst.end()));
+                std::rotate(dst.begin()+first, dst.begin()+first+_elite.size(), dst.end());
+            }
+            
+            /*! Append the e elite individuals in src to dst, and return the
+             position in dst of the first of them.
+             
+             The elite are appended before the embedded strategy runs (and then
+             rotated to the end of dst), in case it reorders src.
+             */
+			template <typename Population, typename EA>
+            std::size_t append_elite(Population& src, Population& dst, std::size_t e, EA& ea) {
+                top_n_indices(src, e, _elite, ea);
+                std::size_t first = dst.size();
+                for(std::size_t i=0; i<_elite.size(); ++i) {
+                    dst.insert(dst.end(), src[_elite[i]]);
                 }
+                return first;
             }
-
+            
 
 			embedded_selection_type _embedded; //!< Underlying selection strategy.
+            std::vector<std::size_t> _elite; //!< Indices of the elite in the source population, most-fit first.
 		};
 
 	} // selection
@@ -20,10 +20,96 @@
 #ifndef _EA_SELECTION_PROPORTIONATE_H_
 #define _EA_SELECTION_PROPORTIONATE_H_
 
+#include <vector>
 #include <ea/access.h>
 #include <ea/selection.h>
 
 namespace ealib {
+    
+    /*! Alias table for sampling from a discrete distribution in O(1) time.
+     
+     The table is built from a sequence of n non-negative weights in O(n) time
+     via Vose's method; afterwards, each index i is drawn with probability
+     w_i / sum(w), using a single random number per draw.
+     */
+    class alias_table {
+    public:
+        //! Constructor.
+        alias_table() {
+        }
+        
+        //! Build this table from the weights in [f,l), which must not sum to zero.
+        template <typename ForwardIterator>
+        void build(ForwardIterator f, ForwardIterator l) {
+            _prob.assign(f, l);
+            const std::size_t n=_prob.size();
+            _alias.resize(n);
+            
+            double sum=0.0;
+            for(std::size_t i=0; i<n; ++i) {
+                sum += _prob[i];
+            }
+            assert(sum > 0.0);
+            
+            // scale the weights so that their mean is 1, and partition them
+            // into those that are less than and at least 1:
+            _small.clear();
+            _large.clear();
+            for(std::size_t i=0; i<n; ++i) {
+                _prob[i] *= static_cast<double>(n) / sum;
+                _alias[i] = i;
+                if(_prob[i] < 1.0) {
+                    _small.push_back(i);
+                } else {
+                    _large.push_back(i);
+                }
+            }
+            
+            // fill each small bucket from a large one:
+            while(!_small.empty() && !_large.empty()) {
+                std::size_t s=_small.back(); _small.pop_back();
+                std::size_t g=_large.back();
+                _alias[s] = g;
+                _prob[g] = (_prob[g] + _prob[s]) - 1.0;
+                if(_prob[g] < 1.0) {
+                    _large.pop_back();
+                    _small.push_back(g);
+                }
+            }
+            
+            // whatever remains is 1, up to rounding error:
+            for(std::size_t i=0; i<_small.size(); ++i) {
+                _prob[_small[i]] = 1.0;
+            }
+            for(std::size_t i=0; i<_large.size(); ++i) {
+                _prob[_large[i]] = 1.0;
+            }
+        }
+        
+        //! Returns the number of entries in this table.
+        std::size_t size() const {
+            return _prob.size();
+        }
+        
+        //! Draw an index from this table.
+        template <typename RNG>
+        std::size_t operator()(RNG& rng) const {
+            // the integer part of u selects a bucket, and the fractional part
+            // selects between that bucket and its alias:
+            double u = rng.p() * static_cast<double>(_prob.size());
+            std::size_t i = static_cast<std::size_t>(u);
+            if(i >= _prob.size()) {
+                i = _prob.size() - 1;
+            }
+            return ((u - static_cast<double>(i)) < _prob[i]) ? i : _alias[i];
+        }
+        
+    protected:
+        std::vector<double> _prob; //!< Probability of keeping each bucket (vs. its alias).
+        std::vector<std::size_t> _alias; //!< Alias of each bucket.
+        std::vector<std::size_t> _small, _large; //!< Scratch space for building the table.
+    };
+    
 	namespace selection {
         
 		/*! Proportionate selection.
@@ -90,6 +176,48 @@ namespace ealib {
             double _offset; //!< Amount by which to offset the attribute being selected over.
 		};
         
+		/*! Proportionate selection via the alias method.
+		 
+         This strategy selects individuals with the same probabilities as
+         proportionate, above (including its offset for populations whose
+         attributes sum to 0.0), but builds an alias table over the source
+         population when constructed, so that each individual is then selected
+         in O(1) time.  It is thus best suited to selecting many individuals
+         from the same population, e.g., all of the parents for a generation.
+		 */
+        template <typename AttributeAccessor=access::fitness>
+		struct alias_proportionate {
+            typedef AttributeAccessor acc_type; //!< Accessor for proportionate selection.
+            
+			//! Initializing constructor.
+			template <typename Population, typename EA>
+			alias_proportionate(std::size_t n, Population& src, EA& ea) {
+                std::vector<double> w;
+                w.reserve(src.size());
+                double sum=0.0;
+                for(typename Population::iterator i=src.begin(); i!=src.end(); ++i) {
+                    w.push_back(static_cast<double>(_acc(**i,ea)));
+                    sum += w.back();
+                }
+                if(sum == 0.0) {
+                    std::fill(w.begin(), w.end(), 1.0);
+                }
+                _table.build(w.begin(), w.end());
+			}
+            
+			//! Select n individuals via proportionate selection.
+			template <typename Population, typename EA>
+			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
+                assert(src.size() == _table.size());
+                for( ; n>0; --n) {
+                    dst.push_back(src[_table(ea.rng())]);
+                }
+            }
+            
+            acc_type _acc; //!< Accessor for value used for proportionate selection.
+            alias_table _table; //!< Alias table over the source population.
+		};
+        
 	} // selection
 } // ealib
 
@@ -20,17 +20,23 @@
 #ifndef _EA_SELECTION_RANK_H_
 #define _EA_SELECTION_RANK_H_
 
-#include <algorithm>
-#include <iterator>
+#include <boost/type_traits/is_same.hpp>
 
 #include <ea/access.h>
 #include <ea/comparators.h>
+#include <ea/selection.h>
 
 namespace ealib {
     
 	namespace selection {
 		
 		/*! Selects individuals based on the rank of their fitness.
+         
+         The n highest-ranked individuals are selected in O(N + n log n) time,
+         highest-ranked first; ties are broken in favor of the individual that
+         appears first in the source population, which is left unmodified.  When
+         ranking by fitness with the default comparator, each individual's
+         fitness is read only once.
 		 */
         template <typename AttributeAccessor=access::fitness, template <typename,typename> class Comparator=comparators::attribute>
 		struct rank {
@@ -42,8 +48,22 @@ namespace ealib {
 			//! Select n individuals via rank selection.
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
-                std::sort(src.begin(), src.end(), Comparator<AttributeAccessor,EA>(ea));
-                algorithm::copy_n(src.rbegin(), std::min(src.size(),n), std::inserter(dst,dst.end()));
+                typedef Comparator<AttributeAccessor,EA> comparator_type;
+                typedef comparators::attribute<access::fitness,EA> fitness_comparator_type;
+                select_impl(src, dst, n, ea, typename boost::is_same<comparator_type,fitness_comparator_type>::type());
+            }
+            
+        protected:
+            //! Select by precomputed fitness.
+			template <typename Population, typename EA>
+			void select_impl(Population& src, Population& dst, std::size_t n, EA& ea, boost::true_type) {
+                select_top_n(src, dst, n, ea);
+            }
+            
+            //! Select via the comparator.
+			template <typename Population, typename EA>
+			void select_impl(Population& src, Population& dst, std::size_t n, EA& ea, boost::false_type) {
+                select_top_n_by(src, dst, n, Comparator<AttributeAccessor,EA>(ea));
             }
         };
 
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 #include <ea/access.h>
 #include <ea/algorithm.h>
 #include <ea/comparators.h>
@@ -39,31 +40,79 @@ namespace ealib {
 		 This selection method runs tournaments of size N and selects the K individuals
 		 with greatest fitness.
 		 
+		 Contestants are drawn without replacement by a partial Fisher-Yates
+		 shuffle of an index buffer that is allocated once per selection (the
+		 buffer remains a permutation after each tournament, so it is never
+		 reset).  When K=1 the winner is found with a single pass over the
+		 contestants; otherwise, the K best are found with a partial sort.  In
+		 both cases, only the winners are copied into the destination population,
+		 in order of decreasing fitness.
+		 
 		 <b>Model of:</b> SelectionStrategyConcept.
 		 */
         template <typename AttributeAccessor=access::fitness, template <typename,typename> class Comparator=comparators::attribute>
 		struct tournament {
             //! Initializing constructor.
 			template <typename Population, typename EA>
-			tournament(std::size_t n, Population& src, EA& ea) { 
+			tournament(std::size_t n, Population& src, EA& ea) : _idx(src.size()) {
+                algorithm::iota(_idx.begin(), _idx.end());
             }
+            
+            //! Orders indices into a population by decreasing attribute.
+            template <typename Population, typename Compare>
+            struct greater_index {
+                greater_index(Population& src, Compare& comp) : _src(src), _comp(comp) {
+                }
+                
+                bool operator()(std::size_t a, std::size_t b) {
+                    return _comp(_src[b], _src[a]);
+                }
+                
+                Population& _src;
+                Compare& _comp;
+            };
 
 			//! Select n individuals via tournament selection.
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
+                typedef Comparator<AttributeAccessor,EA> compare_type;
 				std::size_t N = get<TOURNAMENT_SELECTION_N>(ea);
 				std::size_t K = get<TOURNAMENT_SELECTION_K>(ea);
+                if(_idx.size() != src.size()) {
+                    _idx.resize(src.size());
+                    algorithm::iota(_idx.begin(), _idx.end());
+                }
+                assert(N <= _idx.size());
+                K = std::min(K, N);
+                compare_type comp(ea);
+                
 				while(n > 0) {
-					Population tourney;
-					ea.rng().sample_without_replacement(src.begin(), src.end(), std::back_inserter(tourney), N);
-                    std::sort(tourney.begin(), tourney.end(), Comparator<AttributeAccessor,EA>(ea));
-                    typename Population::reverse_iterator rl=tourney.rbegin();
+                    // draw N contestants into _idx[0,N):
+                    for(std::size_t j=0; j<N; ++j) {
+                        std::swap(_idx[j], _idx[ea.rng()(j, _idx.size())]);
+                    }
+                    
                     std::size_t copy_size = std::min(n,K);
-                    std::advance(rl, copy_size);
-                    dst.insert(dst.end(), tourney.rbegin(), rl);
+                    if(K == 1) {
+                        std::size_t best=_idx[0];
+                        for(std::size_t j=1; j<N; ++j) {
+                            if(comp(src[best], src[_idx[j]])) {
+                                best = _idx[j];
+                            }
+                        }
+                        dst.insert(dst.end(), src[best]);
+                    } else {
+                        greater_index<Population,compare_type> gt(src, comp);
+                        std::partial_sort(_idx.begin(), _idx.begin()+copy_size, _idx.begin()+N, gt);
+                        for(std::size_t j=0; j<copy_size; ++j) {
+                            dst.insert(dst.end(), src[_idx[j]]);
+                        }
+                    }
 					n -= copy_size;
 				}
 			}
+            
+            std::vector<std::size_t> _idx; //!< Scratch permutation of indices into the source population.
 		};
         
 	} // selection
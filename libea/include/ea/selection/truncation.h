@@ -20,10 +20,7 @@
 #ifndef _EA_SELECTION_TRUNCATION_H_
 #define _EA_SELECTION_TRUNCATION_H_
 
-#include <algorithm>
-#include <iterator>
-#include <ea/algorithm.h>
-#include <ea/comparators.h>
+#include <ea/selection.h>
 
 namespace ealib {
 	namespace selection {
@@ -31,7 +28,9 @@ namespace ealib {
 		/*! Truncation selection.
 		 
 		 This selection method truncates a population by removing low-fitness
-         individuals.
+         individuals.  The n most-fit individuals are selected in O(N + n log n)
+         time, most-fit first; ties are broken in favor of the individual that
+         appears first in the source population, which is left unmodified.
 
 		 <b>Model of:</b> SelectionStrategyConcept.
 		 */
@@ -45,10 +44,7 @@ namespace ealib {
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
                 assert(src.size() >= n);
-                std::sort(src.begin(), src.end(), comparators::fitness<EA>(ea));
-                typename Population::reverse_iterator rl=src.rbegin();
-                std::advance(rl, n);
-                dst.insert(dst.end(), src.rbegin(), rl);
+                select_top_n(src, dst, n, ea);
 			}
 		};
 
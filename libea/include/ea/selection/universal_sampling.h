@@ -20,23 +20,28 @@
 #ifndef _EA_SELECTION_UNIVERSAL_SAMPLING_H_
 #define _EA_SELECTION_UNIVERSAL_SAMPLING_H_
 
-#include <ea/attributes.h>
+#include <algorithm>
+#include <ea/access.h>
 #include <ea/selection.h>
 
-#error this file is broken!
-
 namespace ealib {
 	namespace selection {
         
 		/*! Stochastic universal sampling selection.
 		 
          This strategy selects individuals based on some attribute, but does so
-         by selects based on evenly-spaced intervals.  This prevents a single
-         individual from dominating selection.
+         by placing n evenly-spaced pointers (a "comb") over the cumulative
+         attribute, with a single random offset.  Each individual is thus
+         selected either floor(e) or ceil(e) times, where e = n * attr / sum is
+         its expected number of selections under proportionate selection, which
+         prevents a single individual from dominating selection by chance.
          
-         (Think "comb" over a number line.)
+         As with proportionate, if the attribute sums to 0.0 over the population,
+         all individuals are treated as having an attribute of 1.0.  Selected
+         individuals are shuffled before being appended to dst, so that their
+         order does not depend on their position in src.
 		 */
-        template <typename AttributeAccessor=access::fitness_accessor>
+        template <typename AttributeAccessor=access::fitness>
 		struct universal_sampling {
             typedef AttributeAccessor acc_type; //!< Accessor for proportionate selection.
             
@@ -52,64 +57,35 @@ namespace ealib {
                 }
 			}
             
-			/*! Select n individuals via universal sampling.
-             */
+			//! Select n individuals via stochastic universal sampling.
 			template <typename Population, typename EA>
 			void operator()(Population& src, Population& dst, std::size_t n, EA& ea) {
-                // fixed distance (in attribute-space) between individuals (the comb):
-                double p = _sum/static_cast<double>(n);
-                
-                // where do we start?
-                double r = ea.rng().uniform_real(0.0, p);
-                double running = 0.0;
-
-                for( ; n>0; --n) {
-                    
+                if(n == 0) {
+                    return;
                 }
                 
+                // fixed distance (in attribute-space) between pointers, and the
+                // position of the first pointer:
+                const double step = _sum / static_cast<double>(n);
+                const double start = ea.rng().uniform_real(0.0, step);
+                const std::size_t first = dst.size();
                 
-                
-                SUS(Population, N)
-                F := total fitness of population
-                N := number of offspring to keep
-                P := distance between the pointers (F/N)
-                Start := random number between 0 and P
-                Pointers := [Start + i*P | i in [0..N-1]]
-                return RWS(Population,Pointers)
-                
-                RWS(Population, Points)
-                Keep = []
-                i := 0
-                for P in Points
-                while fitness of Population[i] < P
-                i++
-                add Population[i] to Keep
-                return Keep
-                
-                
-                // build a whole bunch of random numbers, and sort them:
-                std::vector<double> rnums(n);
-                std::generate(rnums.begin(), rnums.end(), ea.rng().uniform_real_rng(0,1.0));
-                std::sort(rnums.begin(), rnums.end()); // ascending
-                
-                // since the rnums are sorted, we can scan through linearly.
-                // since the fsum is monotonically increasing, all we need to do is scale
-                // the current rnum by the fraction of fitness we're currently looking at:
-                typename Population::iterator p=src.begin();
+                // walk the pointers and the cumulative attribute together; the
+                // individual whose interval [running-attr, running) contains
+                // each pointer is selected:
+                typename Population::iterator p=src.begin(), last=src.end();
+                --last;
                 double running=static_cast<double>(_acc(**p,ea) + _offset);
-                for(std::vector<double>::iterator i=rnums.begin(); i!=rnums.end(); ++i) {
-                    // while our (the fraction of) running fitness is strictly less than the current
-                    // random number, go to the next individual in the population:
-                    while((running/_sum) < (*i)) {
+                for(std::size_t k=0; k<n; ++k) {
+                    const double pointer = start + static_cast<double>(k) * step;
+                    while((running <= pointer) && (p != last)) {
                         ++p;
-                        assert(p!=src.end());
                         running += static_cast<double>(_acc(**p,ea) + _offset);
                     }
-                    
-                    // ok, running fitness is >= random number; select the p'th
-                    // individual for replication:
                     dst.push_back(*p);
                 }
+                
+                std::random_shuffle(dst.begin()+first, dst.end(), ea.rng());
             }
             
             acc_type _acc; //!< Accessor for value used for proportionate selection.
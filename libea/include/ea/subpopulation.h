@@ -22,6 +22,8 @@
 
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
+#include <ea/individual_id.h>
 
 namespace ealib {
     
@@ -40,15 +42,15 @@ namespace ealib {
         typedef Traits traits_type;
 
         //! Constructor.
-        subpopulation() {
+        subpopulation() : _id(0) {
         }
         
         //! Initializing constructor.
-        subpopulation(const metadata& md) : parent(md) {
+        subpopulation(const metadata& md) : parent(md), _id(0) {
         }
 
         //! Copy constructor.
-        subpopulation(const subpopulation& that) : parent(that), _traits(that._traits) {
+        subpopulation(const subpopulation& that) : parent(that), _traits(that._traits), _id(that._id) {
         }
         
         //! Returns this subpopulation's traits.
@@ -57,8 +59,15 @@ namespace ealib {
         //! Returns this individual's traits (const-qualified).
         const traits_type& traits() const { return _traits; }
         
+        //! Returns this subpopulation's identifier.
+        individual_id_type& id() { return _id; }
+        
+        //! Returns this subpopulation's identifier (const-qualified).
+        individual_id_type id() const { return _id; }
+        
     protected:
         traits_type _traits; //!< This subpopulation's traits.
+        individual_id_type _id; //!< This subpopulation's identifier.
         
     private:
         //! Serialization.
@@ -67,9 +76,30 @@ namespace ealib {
         void serialize(Archive& ar, const unsigned int version) {
             ar & boost::serialization::make_nvp("ea", boost::serialization::base_object<parent>(*this));
             ar & boost::serialization::make_nvp("traits", _traits);
+            if(version > 0) {
+                ar & boost::serialization::make_nvp("id", _id);
+            } else if(Archive::is_loading::value && parent::has_state()) {
+                // version 0 subpopulations stored their identifier in their
+                // EA's meta-data:
+                detail::load_individual_id(_id, parent::md());
+            }
 		}
     };
 
 } // ealib
 
+namespace boost {
+    namespace serialization {
+        
+        //! Version 1 subpopulations serialize their identifier directly.
+        template <typename EA, typename Traits>
+        struct version<ealib::subpopulation<EA,Traits> > {
+            typedef mpl::int_<1> type;
+            typedef mpl::integral_c_tag tag;
+            BOOST_STATIC_CONSTANT(int, value = version::type::value);
+        };
+        
+    } // serialization
+} // boost
+
 #endif
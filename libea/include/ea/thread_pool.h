@@ -0,0 +1,229 @@
+/* thread_pool.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _EA_THREAD_POOL_H_
+#define _EA_THREAD_POOL_H_
+
+#include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <deque>
+
+namespace ealib {
+
+    /*! Simple pool of worker threads.
+
+     Tasks are posted to a FIFO queue and executed by the first available
+     worker.  The pool only ever grows; workers are joined when the pool is
+     destroyed.
+
+     Most code should not use this class directly, but should instead call
+     parallel_for (below), which blocks until all of its work is complete.
+     */
+    class thread_pool {
+    public:
+        typedef boost::function<void()> task_type;
+
+        //! Constructor.
+        thread_pool(std::size_t n=0) : _stop(false) {
+            reserve(n);
+        }
+
+        //! Destructor; waits for all workers to finish.
+        ~thread_pool() {
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                _stop = true;
+            }
+            _cond.notify_all();
+            _threads.join_all();
+        }
+
+        //! Returns the number of worker threads.
+        std::size_t size() {
+            boost::mutex::scoped_lock lock(_mutex);
+            return _threads.size();
+        }
+
+        //! Ensure that this pool has at least n worker threads.
+        void reserve(std::size_t n) {
+            boost::mutex::scoped_lock lock(_mutex);
+            while(_threads.size() < n) {
+                _threads.create_thread(boost::bind(&thread_pool::worker, this));
+            }
+        }
+
+        //! Post a task to be executed by a worker thread.
+        void post(const task_type& t) {
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                _tasks.push_back(t);
+            }
+            _cond.notify_one();
+        }
+
+    protected:
+        //! Worker thread main loop.
+        void worker() {
+            for(;;) {
+                task_type t;
+                {
+                    boost::mutex::scoped_lock lock(_mutex);
+                    while(!_stop && _tasks.empty()) {
+                        _cond.wait(lock);
+                    }
+                    if(_tasks.empty()) {
+                        return; // _stop
+                    }
+                    t = _tasks.front();
+                    _tasks.pop_front();
+                }
+                t();
+            }
+        }
+
+        bool _stop; //!< If true, workers exit once the task queue is empty.
+        std::deque<task_type> _tasks; //!< Queue of pending tasks.
+        boost::thread_group _threads; //!< Worker threads.
+        boost::mutex _mutex; //!< Protects the task queue and thread group.
+        boost::condition_variable _cond; //!< Signals workers that a task is available.
+    };
+
+    //! Returns the process-wide thread pool.
+    inline thread_pool& global_thread_pool() {
+        static thread_pool tp;
+        return tp;
+    }
+
+    namespace detail {
+
+        /*! Shared state for a single call to parallel_for.
+
+         Indices are handed out in chunks of size grain to whichever thread asks
+         next, including the thread that called parallel_for.  Since the caller
+         participates, parallel_for never waits on a worker that has not yet
+         started, and so nested calls (e.g., from inside a task) cannot deadlock.
+         */
+        template <typename Function>
+        struct parallel_for_state {
+            parallel_for_state(std::size_t n, std::size_t grain, Function f)
+            : _n(n), _grain(grain), _next(0), _done(0), _f(f) {
+            }
+
+            //! Execute chunks until none remain.
+            void run() {
+                for(;;) {
+                    std::size_t f, l;
+                    {
+                        boost::mutex::scoped_lock lock(_mutex);
+                        if(_next >= _n) {
+                            return;
+                        }
+                        f = _next;
+                        l = std::min(_n, f + _grain);
+                        _next = l;
+                    }
+                    try {
+                        for(std::size_t i=f; i<l; ++i) {
+                            _f(i);
+                        }
+                    } catch(...) {
+                        boost::mutex::scoped_lock lock(_mutex);
+                        if(!_error) {
+                            _error = boost::current_exception();
+                        }
+                    }
+                    {
+                        boost::mutex::scoped_lock lock(_mutex);
+                        _done += (l - f);
+                        if(_done == _n) {
+                            _cond.notify_all();
+                        }
+                    }
+                }
+            }
+
+            //! Block until all indices have been executed, rethrowing any error.
+            void wait() {
+                {
+                    boost::mutex::scoped_lock lock(_mutex);
+                    while(_done < _n) {
+                        _cond.wait(lock);
+                    }
+                }
+                if(_error) {
+                    boost::rethrow_exception(_error);
+                }
+            }
+
+            std::size_t _n; //!< Number of indices.
+            std::size_t _grain; //!< Number of indices handed out at a time.
+            std::size_t _next; //!< Next index to be handed out.
+            std::size_t _done; //!< Number of indices completed.
+            Function _f; //!< Function to be called for each index.
+            boost::exception_ptr _error; //!< First exception thrown by _f, if any.
+            boost::mutex _mutex;
+            boost::condition_variable _cond;
+        };
+
+        //! Helper task that runs chunks of a parallel_for.
+        template <typename Function>
+        void parallel_for_task(boost::shared_ptr<parallel_for_state<Function> > s) {
+            s->run();
+        }
+
+    } // detail
+
+    /*! Call f(i) for all i in [0,n), using up to the given number of threads
+     (including the calling thread).  Blocks until all calls have completed.
+
+     If threads<=1, f is called sequentially on the calling thread in index
+     order.  Otherwise, the order in which indices are executed is unspecified,
+     and f must be safe to call concurrently for different indices.  If any call
+     to f throws, the first exception caught is rethrown here after all other
+     indices have completed.
+     */
+    template <typename Function>
+    void parallel_for(std::size_t n, Function f, std::size_t threads) {
+        if((threads <= 1) || (n <= 1)) {
+            for(std::size_t i=0; i<n; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        threads = std::min(threads, n);
+        std::size_t grain = std::max(static_cast<std::size_t>(1), n / (4*threads));
+        boost::shared_ptr<detail::parallel_for_state<Function> > s(new detail::parallel_for_state<Function>(n, grain, f));
+
+        thread_pool& tp = global_thread_pool();
+        tp.reserve(threads-1);
+        for(std::size_t i=0; i<(threads-1); ++i) {
+            tp.post(boost::bind(&detail::parallel_for_task<Function>, s));
+        }
+        s->run();
+        s->wait();
+    }
+
+} // ealib
+
+#endif
@@ -19,6 +19,7 @@
  */
 #include "test.h"
 #include <ea/digital_evolution.h>
+#include <ea/digital_evolution/utils/task_switching.h>
 
 
 struct test_lifecycle : default_lifecycle {
@@ -101,6 +102,34 @@ BOOST_AUTO_TEST_CASE(test_resources) {
     BOOST_CHECK_CLOSE(0.0721839, r->level(position_type(1,0)), 0.001);
 }
 
+BOOST_AUTO_TEST_CASE(test_threaded_resources) {
+    metadata md=build_md();
+    put<SPATIAL_X>(37,md);
+    put<SPATIAL_Y>(41,md);
+    put<POPULATION_SIZE>(37*41,md);
+    ea_type ea1(md), ea4(md);
+    
+    // several spatial resources, updated together with 1 and 4 threads:
+    std::vector<ea_type::resource_ptr_type> r1, r4;
+    for(std::size_t i=0; i<3; ++i) {
+        double d=0.05*(i+1);
+        r1.push_back(make_resource("r", d, 0.5, 1.0, 0.75, 0.1, ea1));
+        r4.push_back(make_resource("r", d, 0.5, 1.0, 0.75, 0.1, ea4));
+    }
+    for(std::size_t k=0; k<20; ++k) {
+        ea1.resources().update(1.0, 1);
+        ea4.resources().update(1.0, 4);
+    }
+    
+    for(std::size_t i=0; i<r1.size(); ++i) {
+        for(std::size_t x=0; x<37; ++x) {
+            for(std::size_t y=0; y<41; ++y) {
+                BOOST_CHECK_EQUAL(r1[i]->level(position_type(x,y)), r4[i]->level(position_type(x,y)));
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_avida_hardware) {
     ea_type ea(build_md());
     ea_type::isa_type& isa=ea.isa();
@@ -130,7 +159,7 @@ BOOST_AUTO_TEST_CASE(test_avida_hardware) {
     hw.pushLabelStack(hardware::NOP_C);
     hw.pushLabelStack(hardware::NOP_A);
     hw.pushLabelStack(hardware::NOP_B);
-    std::deque<int> comp_label = hw.getLabelComplement();
+    hardware::label_type comp_label = hw.getLabelComplement();
     BOOST_CHECK_EQUAL(comp_label[0], 0);
     BOOST_CHECK_EQUAL(comp_label[1], 1);
     BOOST_CHECK_EQUAL(comp_label[2], 2);
@@ -138,6 +167,34 @@ BOOST_AUTO_TEST_CASE(test_avida_hardware) {
     std::pair<int, int> c = hw.findComplementLabel();
     BOOST_CHECK_EQUAL(c.first, 3);
     BOOST_CHECK_EQUAL(c.second, 3);
+    
+    // Labels are unbounded, even beyond LABEL_CAPACITY:
+    for(std::size_t i=0; i<2*hardware::LABEL_CAPACITY; ++i) {
+        hw.pushLabelStack(hardware::NOP_A);
+    }
+    BOOST_CHECK_EQUAL(hw.getLabelComplement().size(), 2*hardware::LABEL_CAPACITY+3);
+    BOOST_CHECK_EQUAL(hw.popLabelStack(), static_cast<int>(hardware::NOP_C));
+    BOOST_CHECK_EQUAL(hw.popLabelStack(), static_cast<int>(hardware::NOP_A));
+    BOOST_CHECK_EQUAL(hw.popLabelStack(), static_cast<int>(hardware::NOP_B));
+    std::size_t labels=0;
+    for( ; !hw.isLabelStackEmpty(); ++labels) {
+        BOOST_CHECK_EQUAL(hw.popLabelStack(), static_cast<int>(hardware::NOP_A));
+    }
+    BOOST_CHECK_EQUAL(labels, 2*hardware::LABEL_CAPACITY);
+    
+    // Messages beyond capacity are dropped; the bottom of a full stack is
+    // dropped:
+    for(std::size_t i=0; i<=hardware::STACK_CAPACITY; ++i) {
+        hw.push_stack(static_cast<int>(i));
+        hw.deposit_message(static_cast<int>(i), 0);
+    }
+    BOOST_CHECK_EQUAL(hw.msgs_queued(), static_cast<std::size_t>(hardware::MESSAGE_CAPACITY));
+    BOOST_CHECK_EQUAL(hw.pop_msg().first, 0);
+    std::size_t n=0;
+    for( ; !hw.empty_stack(); ++n) {
+        BOOST_CHECK_EQUAL(hw.pop_stack(), static_cast<int>(hardware::STACK_CAPACITY-n));
+    }
+    BOOST_CHECK_EQUAL(n, static_cast<std::size_t>(hardware::STACK_CAPACITY));
 }
 
 BOOST_AUTO_TEST_CASE(test_avida_instructions) {
@@ -237,6 +294,128 @@ BOOST_AUTO_TEST_CASE(test_logic9_environment) {
     BOOST_CHECK(tequals(x, y, 4294967292));
 }
 
+/*! The fused logic task checker agrees with the logic9 task predicates.
+ */
+BOOST_AUTO_TEST_CASE(test_logic_task_checker) {
+    using namespace ealib::tasks;
+    logic_task_checker c;
+    BOOST_CHECK(c.add(0, logic_functions<task_not>::value));
+    BOOST_CHECK(c.add(1, logic_functions<task_nand>::value));
+    BOOST_CHECK(c.add(2, logic_functions<task_and>::value));
+    BOOST_CHECK(c.add(3, logic_functions<task_ornot>::value));
+    BOOST_CHECK(c.add(4, logic_functions<task_or>::value));
+    BOOST_CHECK(c.add(5, logic_functions<task_andnot>::value));
+    BOOST_CHECK(c.add(6, logic_functions<task_nor>::value));
+    BOOST_CHECK(c.add(7, logic_functions<task_xor>::value));
+    BOOST_CHECK(c.add(8, logic_functions<task_equals>::value));
+    BOOST_CHECK(!c.add(9, logic_functions<task_true>::value));
+    BOOST_CHECK(!c.fused(9));
+
+    default_rng_type rng(1);
+    for(std::size_t i=0; i<10000; ++i) {
+        // rng() is non-negative; shift in a random sign bit:
+        int x=static_cast<int>((static_cast<unsigned int>(rng()) << 1) ^ rng());
+        int y=static_cast<int>((static_cast<unsigned int>(rng()) << 1) ^ rng());
+        switch(i % 4) {
+            case 0: y = x; break; // only two input combinations occur
+            case 1: y = ~x; break;
+            default: break;
+        }
+        int outputs[] = {~x, ~y, ~(x&y), x&y, x|~y, ~x|y, x|y, x&~y, ~x&y, ~(x|y), x^y, ~(x^y), rng()};
+        for(std::size_t j=0; j<13; ++j) {
+            int z=outputs[j];
+            logic_task_checker::mask_type e=0;
+            e |= static_cast<logic_task_checker::mask_type>(task_not()(x,y,z)) << 0;
+            e |= static_cast<logic_task_checker::mask_type>(task_nand()(x,y,z)) << 1;
+            e |= static_cast<logic_task_checker::mask_type>(task_and()(x,y,z)) << 2;
+            e |= static_cast<logic_task_checker::mask_type>(task_ornot()(x,y,z)) << 3;
+            e |= static_cast<logic_task_checker::mask_type>(task_or()(x,y,z)) << 4;
+            e |= static_cast<logic_task_checker::mask_type>(task_andnot()(x,y,z)) << 5;
+            e |= static_cast<logic_task_checker::mask_type>(task_nor()(x,y,z)) << 6;
+            e |= static_cast<logic_task_checker::mask_type>(task_xor()(x,y,z)) << 7;
+            e |= static_cast<logic_task_checker::mask_type>(task_equals()(x,y,z)) << 8;
+            BOOST_CHECK_EQUAL(c(x,y,z), e);
+        }
+    }
+}
+
+/*! Task phenotypes are indexed by the position of each task in the task
+ library.
+ */
+BOOST_AUTO_TEST_CASE(test_task_phenotype) {
+    ea_type ea(build_md());
+    BOOST_CHECK_EQUAL(ea.tasklib().index_of("nand"), 0u);
+    BOOST_CHECK_EQUAL(ea.tasklib().index_of("missing"), ea.tasklib().tasks().size());
+
+    ea_type::individual_ptr_type p=ea.make_individual();
+    BOOST_CHECK(p->phenotype().empty());
+    p->phenotype().performed(0, 0.5);
+    p->phenotype().performed(0, 0.25);
+    p->phenotype().performed(2, 0.0);
+    BOOST_CHECK_EQUAL(p->phenotype().size(), 3u);
+    BOOST_CHECK_EQUAL(p->phenotype().count(0), 2u);
+    BOOST_CHECK_EQUAL(p->phenotype().count(1), 0u);
+    BOOST_CHECK_EQUAL(p->phenotype().value(0), 0.75);
+    BOOST_CHECK(!p->phenotype().any_other(0));
+    BOOST_CHECK(p->phenotype().any_other(2));
+
+    std::map<std::string,double> m=ea.tasklib().phenotype_map(*p);
+    BOOST_CHECK_EQUAL(m.size(), 1u);
+    BOOST_CHECK_EQUAL(m["nand"], 0.75);
+    
+    // phenotypes keyed by task name, as in older checkpoints, survive
+    // serialization, and are converted to task indices when next used:
+    ea_type::individual_ptr_type q=ea.make_individual();
+    task_phenotype::legacy_map_type legacy;
+    legacy["nand"] = 0.75;
+    legacy["missing"] = 1.0;
+    q->phenotype().legacy(legacy);
+    
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << boost::serialization::make_nvp("phenotype", q->phenotype());
+    }
+    task_phenotype r;
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive ia(in);
+        ia >> boost::serialization::make_nvp("phenotype", r);
+    }
+    BOOST_CHECK(r == q->phenotype());
+    BOOST_CHECK(r.has_legacy());
+    
+    m = ea.tasklib().phenotype_map(*q);
+    BOOST_CHECK(!q->phenotype().has_legacy());
+    BOOST_CHECK_EQUAL(m.size(), 1u);
+    BOOST_CHECK_EQUAL(m["nand"], 0.75);
+    
+    // merit earned before the checkpoint is not lost:
+    q->phenotype().clear();
+    q->phenotype().legacy(legacy);
+    ea.tasklib().prioritize(*q, ea);
+    ea.tasklib().prioritize(*p, ea);
+    BOOST_CHECK(q->priority() > 1.0);
+    BOOST_CHECK(q->priority() == p->priority());
+    BOOST_CHECK(q->phenotype().empty() && !q->phenotype().has_legacy());
+}
+
+/*! LAST_TASK recorded by task name, as in older checkpoints, is read as the
+ task's index.
+ */
+BOOST_AUTO_TEST_CASE(test_legacy_last_task) {
+    ea_type ea(build_md());
+    ea_type::individual_ptr_type p=ea.make_individual();
+    BOOST_CHECK_EQUAL(last_task(*p, ea), -1);
+    
+    p->md().set("ea.ts.last_task", "nand");
+    BOOST_CHECK_EQUAL(last_task(*p, ea), 0);
+    BOOST_CHECK_EQUAL(get<LAST_TASK>(*p), 0);
+    
+    p->md().set("ea.ts.last_task", "missing");
+    BOOST_CHECK_EQUAL(last_task(*p, ea), -1);
+}
+
 
 BOOST_AUTO_TEST_CASE(test_ea_type) {
     ea_type ea(build_md());
@@ -277,6 +456,18 @@ BOOST_AUTO_TEST_CASE(test_ea_type) {
     
     BOOST_CHECK(i1.repr() == i2.repr());
     BOOST_CHECK(i1.hw() == i2.hw());
+    
+    // ...and again with a compressed binary checkpoint:
+    std::ostringstream bout;
+    checkpoint::save(bout, ea, checkpoint::binary_format, true);
+    
+    ea_type ea3;
+    std::istringstream bin(bout.str());
+    checkpoint::load(bin, ea3);
+    
+    ea_type::individual_type& i3=*ea3.population()[0];
+    BOOST_CHECK(i1.repr() == i3.repr());
+    BOOST_CHECK(i1.hw() == i3.hw());
 }
 
 
@@ -371,3 +562,160 @@ BOOST_AUTO_TEST_CASE(test_digevo_checkpoint) {
     BOOST_CHECK(ea.env() == ea2.env());
     BOOST_CHECK(ea.rng() == ea2.rng());
 }
+
+//! Reads indel meta-data, as an indel mutation operator would.
+DIGEVO_INSTRUCTION_DECL(read_indel_md) {
+    int rbx = hw.modifyRegister();
+    hw.setRegValue(rbx, get<MUTATION_INDEL_MIN_SIZE>(ea) + get<MUTATION_INDEL_MAX_SIZE>(ea)
+                   + static_cast<int>(100.0 * (get<MUTATION_INSERTION_P>(ea) + get<MUTATION_DELETION_P>(ea))));
+}
+
+//! Test lifecycle that also reads indel meta-data while individuals execute.
+struct tiled_test_lifecycle : test_lifecycle {
+    template <typename EA>
+    void after_initialization(EA& ea) {
+        test_lifecycle::after_initialization(ea);
+        append_isa<read_indel_md>(ea);
+    }
+};
+
+//! Generates a repro ancestor that first reads indel meta-data.
+struct read_indel_ancestor {
+    template <typename EA>
+    typename EA::genome_type operator()(EA& ea) {
+        typename EA::genome_type repr=repro_ancestor()(ea);
+        repr[0] = ea.isa()["read_indel_md"];
+        return repr;
+    }
+};
+
+typedef digital_evolution
+< tiled_test_lifecycle
+, recombination::asexual
+, tiled_weighted_round_robin< >
+> tiled_ea_type;
+
+template <typename EA>
+struct count_births : birth_event<EA> {
+    count_births(EA& ea) : birth_event<EA>(ea), n(0) { }
+    virtual ~count_births() { }
+    virtual void operator()(typename EA::individual_type& offspring,
+                            typename EA::individual_type& parent,
+                            EA& ea) {
+        ++n;
+    }
+    std::size_t n;
+};
+
+/*! The tiled scheduler produces the same results regardless of the number of
+ threads, including when meta-data is first converted from strings by
+ concurrently executing individuals.
+ */
+BOOST_AUTO_TEST_CASE(test_tiled_scheduler) {
+    metadata md=build_md();
+    put<SPATIAL_X>(24,md);
+    put<SPATIAL_Y>(24,md);
+    put<POPULATION_SIZE>(24*24,md);
+    put<SCHEDULER_TILE_SIZE>(4,md);
+    md.set(MUTATION_PER_SITE_P::key(), "0.0075");
+    md.set(MUTATION_INSERTION_P::key(), "0.05");
+    md.set(MUTATION_DELETION_P::key(), "0.05");
+    md.set(MUTATION_INDEL_MIN_SIZE::key(), "1");
+    md.set(MUTATION_INDEL_MAX_SIZE::key(), "2");
+    md.set(SCHEDULER_THREADS::key(), "1");
+    tiled_ea_type ea1(md);
+    md.set(SCHEDULER_THREADS::key(), "4");
+    tiled_ea_type ea4(md);
+    count_births<tiled_ea_type> b1(ea1), b4(ea4);
+    
+    generate_ancestors(read_indel_ancestor(), 1, ea1);
+    generate_ancestors(read_indel_ancestor(), 1, ea4);
+    ea1.lifecycle().advance_epoch(100,ea1);
+    ea4.lifecycle().advance_epoch(100,ea4);
+    
+    BOOST_CHECK(ea1.size() > 100);
+    BOOST_CHECK(b1.n > ea1.size());
+    BOOST_CHECK_EQUAL(b1.n, b4.n);
+    BOOST_CHECK_EQUAL(ea1.size(), ea4.size());
+    BOOST_CHECK(ea1.population() == ea4.population());
+    BOOST_CHECK(ea1.rng() == ea4.rng());
+    for(std::size_t i=0; i<std::min(ea1.size(), ea4.size()); ++i) {
+        BOOST_CHECK_EQUAL(ea1.population()[i]->id(), ea4.population()[i]->id());
+    }
+}
+
+typedef digital_evolution
+< test_lifecycle
+, recombination::asexual
+, probabilistic< >
+> probabilistic_ea_type;
+
+/*! The probabilistic scheduler keeps the weight of each individual in the
+ population equal to its priority.
+ */
+BOOST_AUTO_TEST_CASE(test_probabilistic_scheduler) {
+    metadata md=build_md();
+    put<SPATIAL_X>(24,md);
+    put<SPATIAL_Y>(24,md);
+    put<POPULATION_SIZE>(24*24,md);
+    probabilistic_ea_type ea(md);
+    count_births<probabilistic_ea_type> b(ea);
+    generate_ancestors(repro_ancestor(), 1, ea);
+    ea.lifecycle().advance_epoch(100,ea);
+    
+    BOOST_CHECK(ea.size() > 100);
+    BOOST_CHECK(b.n > ea.size());
+    BOOST_CHECK_EQUAL(ea.scheduler()._weights.size(), ea.size());
+    for(std::size_t i=0; i<ea.size(); ++i) {
+        BOOST_CHECK(ea.population()[i]->alive());
+        BOOST_CHECK_EQUAL(ea.scheduler()._weights[i], static_cast<double>(ea.population()[i]->priority()));
+    }
+}
+
+/*! The probabilistic scheduler executes individuals in proportion to their
+ priorities, and does not execute individuals with zero priority, even when
+ rounding error leaves a residue in its partial sums.
+ */
+BOOST_AUTO_TEST_CASE(test_probabilistic_priorities) {
+    probabilistic_ea_type ea(build_md());
+    generate_ancestors(nopx_ancestor(), 4, ea);
+    BOOST_REQUIRE_EQUAL(ea.size(), 4u);
+    ea.population()[0]->priority() = 1.0;
+    ea.population()[1]->priority() = 2.0;
+    ea.population()[2]->priority() = 4.0;
+    ea.population()[3]->priority() = 0.0;
+    ea.scheduler().link(ea);
+    
+    put<SCHEDULER_TIME_SLICE>(7000,ea);
+    ea.scheduler()(ea.population(),ea);
+    
+    BOOST_REQUIRE_EQUAL(ea.size(), 4u);
+    double a0=ea.population()[0]->hw().age();
+    double a1=ea.population()[1]->hw().age();
+    double a2=ea.population()[2]->hw().age();
+    BOOST_CHECK_EQUAL(a0 + a1 + a2, 28000.0);
+    BOOST_CHECK_CLOSE(a1/a0, 2.0, 10.0);
+    BOOST_CHECK_CLOSE(a2/a0, 4.0, 10.0);
+    BOOST_CHECK_EQUAL(ea.population()[3]->hw().age(), 0);
+    
+    // zero all priorities in an order that leaves a positive residue:
+    double w[]={0.1, 0.1, 0.1, 0.0};
+    for(std::size_t i=0; i<4; ++i) {
+        ea.population()[i]->priority() = w[i];
+    }
+    ea.scheduler().link(ea);
+    for(std::size_t i=0; i<4; ++i) {
+        ea.population()[i]->priority() = 0.0;
+        ea.scheduler()._weights.set(i, 0.0);
+    }
+    BOOST_REQUIRE(ea.scheduler()._weights.sum() > 0.0);
+    
+    ea.scheduler()(ea.population(),ea);
+    BOOST_CHECK_EQUAL(a0 + a1 + a2, static_cast<double>(ea.population()[0]->hw().age()
+                                                      + ea.population()[1]->hw().age()
+                                                      + ea.population()[2]->hw().age()));
+    BOOST_CHECK_EQUAL(ea.population()[3]->hw().age(), 0);
+    
+    put<SCHEDULER_QUANTUM>(0,ea);
+    BOOST_CHECK_THROW(ea.scheduler()(ea.population(),ea), bad_argument_exception);
+}
@@ -0,0 +1,103 @@
+/* test_events.cpp
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "test.h"
+#include <ea/event_bus.h>
+
+
+//! Records the order in which slots are called.
+struct recorder {
+    recorder(std::vector<int>& calls, int id) : _calls(calls), _id(id), _bus(0) { }
+    void operator()(int x) { _calls.push_back(_id*100 + x); }
+    void once(int x) { operator()(x); _conn.disconnect(); }
+    void connect_another(int x) { operator()(x); _bus->connect(recorder(_calls, 9)); }
+    std::vector<int>& _calls;
+    int _id;
+    event_bus<void(int)>* _bus;
+    connection _conn;
+};
+
+/*! Event buses call ordered slots first, in order, followed by unordered slots
+ in order of connection; slots may be disconnected, including during emission.
+ */
+BOOST_AUTO_TEST_CASE(test_event_bus) {
+    event_bus<void(int)> bus;
+    std::vector<int> calls;
+    bus(0); // no slots
+    BOOST_CHECK(bus.empty());
+
+    recorder r1(calls,1), r2(calls,2), r3(calls,3), r4(calls,4);
+    bus.connect<recorder, &recorder::operator()>(&r1);
+    bus.connect<recorder, &recorder::operator()>(2, &r2);
+    r3._conn = bus.connect<recorder, &recorder::once>(1, &r3);
+    connection c4=bus.connect(r4);
+    BOOST_CHECK_EQUAL(bus.num_slots(), 4u);
+
+    bus(1);
+    int e1[] = {301, 201, 101, 401};
+    BOOST_CHECK_EQUAL(calls.size(), 4u);
+    BOOST_CHECK(std::equal(e1, e1+4, calls.begin()));
+    BOOST_CHECK(!r3._conn.connected());
+    BOOST_CHECK_EQUAL(bus.num_slots(), 3u);
+
+    // slots connected during emission are called from the next emission on:
+    calls.clear();
+    c4.disconnect();
+    r2._bus = &bus;
+    {
+        scoped_connection c5(bus.connect<recorder, &recorder::connect_another>(&r2));
+        bus(2);
+        bus(3);
+    }
+    int e2[] = {202, 102, 202, 203, 103, 203, 903};
+    BOOST_CHECK_EQUAL(calls.size(), 7u);
+    BOOST_CHECK(std::equal(e2, e2+7, calls.begin()));
+    BOOST_CHECK_EQUAL(bus.num_slots(), 4u);
+
+    bus.disconnect_all_slots();
+    BOOST_CHECK(bus.empty());
+}
+
+template <typename EA>
+struct count_inheritance : inheritance_event<EA> {
+    count_inheritance(EA& ea) : inheritance_event<EA>(ea), n(0) { }
+    virtual ~count_inheritance() { }
+    virtual void operator()(typename EA::population_type& parents,
+                            typename EA::individual_type& offspring,
+                            EA& ea) {
+        ++n;
+    }
+    int n;
+};
+
+/*! Event subclasses are called through their virtual members, and disconnect
+ when destroyed.
+ */
+BOOST_AUTO_TEST_CASE(test_inheritance_event) {
+    all_ones_ea ea(build_ea_md());
+    generate_initial_population(ea);
+    {
+        count_inheritance<all_ones_ea> c(ea);
+        BOOST_CHECK_EQUAL(ea.events().inheritance.num_slots(), 1u);
+        ea.lifecycle().advance_epoch(1,ea);
+        BOOST_CHECK(c.n > 0);
+    }
+    BOOST_CHECK(ea.events().inheritance.empty());
+    ea.lifecycle().advance_epoch(1,ea);
+}
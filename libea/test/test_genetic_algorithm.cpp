@@ -18,6 +18,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "test.h"
+#include <ea/genome_types/packed_bitstring.h>
+#include <ea/genome_types/chunked_genome.h>
+#include <ea/archive.h>
 
 
 BOOST_AUTO_TEST_CASE(test_genetic_algorithm) {
@@ -25,3 +28,240 @@ BOOST_AUTO_TEST_CASE(test_genetic_algorithm) {
     all_ones_ea ea(build_ea_md());
     ea.lifecycle().advance_epoch(10,ea);
 }
+
+typedef evolutionary_algorithm
+< direct<packed_bitstring>
+, all_ones
+, mutation::operators::packed_bitflip
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> packed_all_ones_ea;
+
+BOOST_AUTO_TEST_CASE(test_packed_bitstring) {
+    using namespace ealib;
+    default_rng_type rng(1);
+    bitstring a, b;
+    for(std::size_t i=0; i<200; ++i) {
+        a.push_back(rng.bit());
+        b.push_back(rng.bit());
+    }
+    packed_bitstring pa(a.begin(), a.end()), pb(b.begin(), b.end());
+    BOOST_CHECK_EQUAL(pa.size(), 200u);
+    BOOST_CHECK(std::equal(a.begin(), a.end(), pa.begin()));
+    BOOST_CHECK_EQUAL(count_ones(pa), count_ones(a));
+    
+    // word-level swap at unaligned offsets should match the element-wise swap:
+    swap_ranges(a, 3, b, 70, 129);
+    swap_ranges(pa, 3, pb, 70, 129);
+    BOOST_CHECK(std::equal(a.begin(), a.end(), pa.begin()));
+    BOOST_CHECK(std::equal(b.begin(), b.end(), pb.begin()));
+    
+    // and so should the proxy references used by site mutations:
+    packed_bitstring::iterator i=pa.begin()+65;
+    *i ^= 0x01;
+    a[65] ^= 0x01;
+    BOOST_CHECK(std::equal(a.begin(), a.end(), pa.begin()));
+    
+    pa.resize(67, 1);
+    BOOST_CHECK_EQUAL(pa.count(), static_cast<std::size_t>(std::count(a.begin(), a.begin()+67, 1)));
+    pa.resize(130, 1);
+    BOOST_CHECK_EQUAL(pa.count(), static_cast<std::size_t>(std::count(a.begin(), a.begin()+67, 1)) + 63u);
+    
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << BOOST_SERIALIZATION_NVP(pa);
+    }
+    packed_bitstring pc;
+    {
+        std::istringstream in(out.str());
+        boost::archive::xml_iarchive ia(in);
+        ia >> boost::serialization::make_nvp("pa", pc);
+    }
+    BOOST_CHECK(pa == pc);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_genetic_algorithm) {
+    using namespace ealib;
+    packed_all_ones_ea ea(build_ea_md());
+    generate_initial_population(ea);
+    ea.lifecycle().advance_epoch(10,ea);
+    BOOST_CHECK_EQUAL(ea.population()[0]->genome().size(), static_cast<std::size_t>(get<REPRESENTATION_SIZE>(ea)));
+}
+
+BOOST_AUTO_TEST_CASE(test_geometric_skip) {
+    using namespace ealib;
+    default_rng_type rng(1);
+    const std::size_t max_skip=std::numeric_limits<std::size_t>::max();
+    
+    // p<=0 never selects a site, and p>=1 selects every site:
+    mutation::geometric_skip never(0.0), negative(-0.5), always(1.0), over(1.5);
+    for(std::size_t i=0; i<100; ++i) {
+        BOOST_CHECK_EQUAL(never(rng), max_skip);
+        BOOST_CHECK_EQUAL(negative(rng), max_skip);
+        BOOST_CHECK_EQUAL(always(rng), 0u);
+        BOOST_CHECK_EQUAL(over(rng), 0u);
+    }
+    
+    // vanishingly small p saturates rather than overflowing:
+    mutation::geometric_skip tiny(1e-300);
+    BOOST_CHECK_EQUAL(tiny(rng), max_skip);
+    
+    // gaps have mean (1-p)/p:
+    mutation::geometric_skip skip(0.01);
+    double total=0.0;
+    for(std::size_t i=0; i<10000; ++i) {
+        total += skip(rng);
+    }
+    BOOST_CHECK_CLOSE(total/10000.0, 99.0, 5.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_geometric_per_site) {
+    using namespace ealib;
+    all_ones_ea ea(build_ea_md());
+    ea.rng().reset(3);
+    
+    all_ones_ea::individual_type ind;
+    ind.genome().resize(10000);
+    mutation::operators::geometric_per_site<mutation::site::bitflip> m;
+    
+    // no mutations at p=0, every site mutated at p=1:
+    put<MUTATION_PER_SITE_P>(0.0,ea);
+    m(ind,ea);
+    BOOST_CHECK_EQUAL(count_ones(ind.genome()), 0u);
+    put<MUTATION_PER_SITE_P>(1.0,ea);
+    m(ind,ea);
+    BOOST_CHECK_EQUAL(count_ones(ind.genome()), 10000u);
+    
+    // otherwise, mutations are binomial(n,p) and uniform over sites; 200
+    // trials of 10000 sites at p=0.001 gives mean 2000, sd ~44.7 in total:
+    put<MUTATION_PER_SITE_P>(0.001,ea);
+    std::size_t total=0, first_half=0;
+    for(std::size_t t=0; t<200; ++t) {
+        std::fill(ind.genome().begin(), ind.genome().end(), 0);
+        m(ind,ea);
+        total += count_ones(ind.genome());
+        first_half += std::count(ind.genome().begin(), ind.genome().begin()+5000, 1);
+    }
+    BOOST_CHECK((total > 1800) && (total < 2200));
+    BOOST_CHECK((first_half > (total/2 - 150)) && (first_half < (total/2 + 150)));
+}
+
+typedef evolutionary_algorithm
+< direct<bitstring>
+, all_ones
+, mutation::operators::per_site<mutation::site::bitflip>
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+, dont_stop
+, fill_population
+, default_lifecycle
+, fitness_trait
+, pooled_individualS
+> pooled_all_ones_ea;
+
+/*! Pooled individuals recycle storage, and evolve and checkpoint exactly as
+ shared individuals do.
+ */
+BOOST_AUTO_TEST_CASE(test_pooled_individuals) {
+    using namespace ealib;
+    pooled_all_ones_ea ea1(build_ea_md());
+    all_ones_ea ea2(build_ea_md());
+    
+    // storage of a dead individual is reused:
+    pooled_all_ones_ea::individual_type* p=ea1.make_individual().get();
+    pooled_all_ones_ea::individual_ptr_type q=ea1.make_individual();
+    BOOST_CHECK(q.get() == p);
+    pooled_all_ones_ea::individual_ptr_type r=q;
+    q.reset();
+    BOOST_CHECK(r.get() == p);
+    
+    // identical evolution:
+    ea1.lifecycle().advance_epoch(10,ea1);
+    ea2.lifecycle().advance_epoch(10,ea2);
+    BOOST_CHECK_EQUAL(ea1.size(), ea2.size());
+    for(std::size_t i=0; i<ea1.size(); ++i) {
+        BOOST_CHECK(ea1.population()[i]->genome() == ea2.population()[i]->genome());
+    }
+    
+    // checkpoints are interchangeable:
+    std::ostringstream out;
+    checkpoint::save(out, ea1);
+    all_ones_ea ea3;
+    std::istringstream in(out.str());
+    checkpoint::load(in, ea3);
+    BOOST_CHECK_EQUAL(ea1.size(), ea3.size());
+    for(std::size_t i=0; i<ea1.size(); ++i) {
+        BOOST_CHECK(ea1.population()[i]->genome() == ea3.population()[i]->genome());
+        BOOST_CHECK(ea1.population()[i]->id() == ea3.population()[i]->id());
+    }
+}
+
+typedef evolutionary_algorithm
+< direct<chunked_genome<int,64> >
+, all_ones
+, mutation::operators::geometric_per_site<mutation::site::bitflip>
+, recombination::asexual
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> chunked_all_ones_ea;
+
+/*! Chunked genomes share storage among copies until written.
+ */
+BOOST_AUTO_TEST_CASE(test_chunked_genome) {
+    using namespace ealib;
+    typedef chunked_genome<int,64> genome_type;
+    genome_type g(200, 0);
+    BOOST_CHECK_EQUAL(g.size(), 200u);
+    BOOST_CHECK_EQUAL(g.num_chunks(), 4u);
+    
+    // copies share chunks; reading via non-const iterators doesn't copy them:
+    genome_type h(g);
+    BOOST_CHECK_EQUAL(std::count(h.begin(), h.end(), 0), 200);
+    for(std::size_t c=0; c<g.num_chunks(); ++c) {
+        BOOST_CHECK(g.chunk_data(c) == h.chunk_data(c));
+    }
+    
+    // writing copies only the affected chunk:
+    h[70] ^= 1;
+    h[71] = 1;
+    BOOST_CHECK_EQUAL(g[70], 0);
+    BOOST_CHECK_EQUAL(h[70], 1);
+    BOOST_CHECK(g.chunk_data(0) == h.chunk_data(0));
+    BOOST_CHECK(g.chunk_data(1) != h.chunk_data(1));
+    BOOST_CHECK(g.chunk_data(2) == h.chunk_data(2));
+    BOOST_CHECK(g != h);
+    h[70] = 0; h[71] = 0;
+    BOOST_CHECK(g == h);
+    
+    // insert and erase:
+    int ones[] = {1, 1, 1};
+    h.insert(h.begin()+10, ones, ones+3);
+    BOOST_CHECK_EQUAL(h.size(), 203u);
+    BOOST_CHECK_EQUAL(std::count(h.begin(), h.end(), 1), 3);
+    BOOST_CHECK_EQUAL(h[12], 1);
+    h.erase(h.begin()+10, h.begin()+13);
+    BOOST_CHECK(g == h);
+    
+    // serialization is compatible with numeric_vector:
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << boost::serialization::make_nvp("g", h);
+    }
+    std::istringstream in(out.str());
+    bitstring b;
+    {
+        boost::archive::xml_iarchive ia(in);
+        ia >> boost::serialization::make_nvp("g", b);
+    }
+    BOOST_CHECK_EQUAL(b.size(), h.size());
+    BOOST_CHECK(std::equal(b.begin(), b.end(), static_cast<const genome_type&>(h).begin()));
+    
+    chunked_all_ones_ea ea(build_ea_md());
+    generate_initial_population(ea);
+    ea.lifecycle().advance_epoch(10,ea);
+    BOOST_CHECK_EQUAL(ea.population()[0]->genome().size(), static_cast<std::size_t>(get<REPRESENTATION_SIZE>(ea)));
+}
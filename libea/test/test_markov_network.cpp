@@ -25,6 +25,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <ea/mkv/markov_network_evolution.h>
+#include <mkv/compiled_network.h>
 #include <ea/data_structures/circular_vector.h>
 
 
@@ -305,3 +306,96 @@ BOOST_AUTO_TEST_CASE(test_markov_network) {
         BOOST_CHECK(g.M(7,1)==0.0);
     }
 }
+
+BOOST_AUTO_TEST_CASE(test_compiled_markov_network) {
+    using namespace ealib;
+    using namespace mkv;
+    typedef markov_network< > network_type;
+    
+    // random network with logic, probabilistic, and adaptive gates:
+    default_rng_type rng(7);
+    network_type N(4,3,5,42);
+    for(std::size_t i=0; i<12; ++i) {
+        network_type::abstract_gate_ptr p;
+        std::size_t nin=rng(1,4), nout=rng(1,4);
+        switch(i%3) {
+            case 0: {
+                logic_gate<default_rng_type>* g=new logic_gate<default_rng_type>();
+                g->M.resize(1<<nin);
+                for(std::size_t j=0; j<g->M.size(); ++j) {
+                    g->M[j] = rng(1<<nout);
+                }
+                p.reset(g);
+                break;
+            }
+            case 1: {
+                probabilistic_gate<default_rng_type>* g=new probabilistic_gate<default_rng_type>();
+                g->M.resize(1<<nin, 1<<nout);
+                for(std::size_t j=0; j<g->M.size1(); ++j) {
+                    for(std::size_t k=0; k<g->M.size2(); ++k) {
+                        g->M(j,k) = rng.p();
+                    }
+                }
+                g->normalize();
+                p.reset(g);
+                break;
+            }
+            case 2: {
+                adaptive_gate<default_rng_type>* g=new adaptive_gate<default_rng_type>();
+                nin += 2; // feedback bits
+                g->h = 3;
+                g->P.resize(3); g->N.resize(3);
+                for(std::size_t j=0; j<3; ++j) {
+                    g->P[j] = rng.p();
+                    g->N[j] = -rng.p();
+                }
+                g->M.resize(1<<(nin-2), 1<<nout);
+                for(std::size_t j=0; j<g->M.size1(); ++j) {
+                    for(std::size_t k=0; k<g->M.size2(); ++k) {
+                        g->M(j,k) = rng.p();
+                    }
+                }
+                g->normalize();
+                g->Q = g->M;
+                p.reset(g);
+                break;
+            }
+        }
+        p->inputs.resize(nin);
+        p->outputs.resize(nout);
+        for(std::size_t j=0; j<nin; ++j) {
+            p->inputs[j] = rng(N.nstates());
+        }
+        for(std::size_t j=0; j<nout; ++j) {
+            p->outputs[j] = rng(N.ninputs(), N.nstates());
+        }
+        N.gates().push_back(p);
+    }
+    
+    compiled_markov_network< > C(N);
+    BOOST_CHECK_EQUAL(C.ngates(), N.ngates());
+    BOOST_CHECK_EQUAL(C.nstates(), N.nstates());
+    
+    // the compiled network should track the original exactly:
+    int in[4];
+    for(std::size_t t=0; t<200; ++t) {
+        for(std::size_t j=0; j<4; ++j) {
+            in[j] = rng.bit();
+        }
+        N.update(in);
+        C.update(in);
+        for(std::size_t j=0; j<N.nstates(); ++j) {
+            BOOST_CHECK_EQUAL(N(j), C(j));
+        }
+        if(t == 100) {
+            N.clear();
+            C.clear();
+        }
+    }
+    for(std::size_t i=0; i<N.ngates(); ++i) {
+        if(adaptive_gate<default_rng_type>* g=dynamic_cast<adaptive_gate<default_rng_type>*>(N.gates()[i].get())) {
+            BOOST_CHECK(!std::equal(g->M.data().begin(), g->M.data().end(), g->Q.data().begin())); // adaptation happened
+        }
+    }
+    BOOST_CHECK(N.rng() == C.rng());
+}
@@ -18,6 +18,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "test.h"
+#include <boost/thread/thread.hpp>
+#include <ea/thread_pool.h>
 
 BOOST_AUTO_TEST_CASE(test_md) {
     all_ones_ea ea1(build_ea_md()), ea2;
@@ -37,3 +39,91 @@ BOOST_AUTO_TEST_CASE(test_md) {
 	BOOST_CHECK_EQUAL(get<MUTATION_PER_SITE_P>(ea1), 1.0);
 	BOOST_CHECK_EQUAL(get<MUTATION_PER_SITE_P>(ea1), get<MUTATION_PER_SITE_P>(ea2));
 }
+
+//! Slotted attribute that is only ever accessed by key.
+LIBEA_MD_SLOT_DECL(LAST_SLOTTED_MD, "test.last_slotted_md", int);
+
+BOOST_AUTO_TEST_CASE(test_slotted_md) {
+    metadata md1, md2;
+    BOOST_CHECK(!md1.exists(IND_GENERATION::key()));
+    BOOST_CHECK_EQUAL(get<IND_GENERATION>(md1,1.0), 1.0);
+    put<IND_GENERATION>(2.0,md1);
+    put<IND_UNIQUE_NAME>(std::string("abc"),md1);
+    BOOST_CHECK(md1.exists(IND_GENERATION::key()));
+    BOOST_CHECK_EQUAL(get<IND_GENERATION>(md1), 2.0);
+    
+    // string-keyed access overrides slotted values:
+    md1.set(IND_GENERATION::key(), "3.0");
+    BOOST_CHECK_EQUAL(get<IND_GENERATION>(md1), 3.0);
+    
+    // slotted values are serialized under their keys:
+    put<IND_GENERATION>(4.0,md1);
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << BOOST_SERIALIZATION_NVP(md1);
+    }
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive ia(in);
+        ia >> BOOST_SERIALIZATION_NVP(md2);
+    }
+    BOOST_CHECK_EQUAL(get<IND_GENERATION>(md2), 4.0);
+    BOOST_CHECK_EQUAL(get<IND_UNIQUE_NAME>(md2), "abc");
+    BOOST_CHECK_EQUAL(md2.getattr<IND_GENERATION>(IND_GENERATION::key()), 4.0);
+    
+    // copies hold their own slotted values:
+    metadata md3(md2);
+    put<IND_GENERATION>(5.0,md3);
+    put<IND_UNIQUE_NAME>(std::string("a name longer than the small-string buffer"),md3);
+    BOOST_CHECK_EQUAL(get<IND_GENERATION>(md2), 4.0);
+    BOOST_CHECK_EQUAL(get<IND_UNIQUE_NAME>(md2), "abc");
+    md2 = md3;
+    BOOST_CHECK_EQUAL(get<IND_UNIQUE_NAME>(md2), "a name longer than the small-string buffer");
+    BOOST_CHECK(exists<IND_GENERATION>(md3));
+    BOOST_CHECK(!exists<IND_BIRTH_UPDATE>(md3));
+    
+    // slotted attributes are registered during static initialization:
+    std::size_t s;
+    BOOST_CHECK(detail::slot_registry::instance().find(LAST_SLOTTED_MD::key(), s));
+    BOOST_CHECK_EQUAL(detail::slot_registry::instance().key(s), LAST_SLOTTED_MD::key());
+}
+
+//! Reads mutation meta-data, as mutation operators would.
+struct read_mutation_md {
+    read_mutation_md(metadata& md, std::vector<double>& sums) : _md(md), _sums(sums) { }
+    void operator()(std::size_t i) {
+        _sums[i] = get<MUTATION_PER_SITE_P>(_md) + get<MUTATION_INSERTION_P>(_md)
+        + get<MUTATION_DELETION_P>(_md) + get<MUTATION_INDEL_MIN_SIZE>(_md)
+        + get<MUTATION_INDEL_MAX_SIZE>(_md) + get<RECORDING_PERIOD>(_md,10);
+        // give other threads a chance to run:
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+    metadata& _md;
+    std::vector<double>& _sums;
+};
+
+/*! Concurrent meta-data can be read from multiple threads, including values
+ that have not yet been converted from their strings.
+ */
+BOOST_AUTO_TEST_CASE(test_concurrent_md) {
+    metadata md;
+    md.set(MUTATION_PER_SITE_P::key(), "0.5");
+    md.set(MUTATION_INSERTION_P::key(), "0.25");
+    md.set(MUTATION_DELETION_P::key(), "0.125");
+    md.set(MUTATION_INDEL_MIN_SIZE::key(), "1");
+    md.set(MUTATION_INDEL_MAX_SIZE::key(), "8");
+    
+    md.concurrent(true);
+    std::vector<double> sums(64, 0.0);
+    parallel_for(sums.size(), read_mutation_md(md, sums), 4);
+    BOOST_CHECK(md.exists(RECORDING_PERIOD::key()));
+    md.concurrent(false);
+    
+    for(std::size_t i=0; i<sums.size(); ++i) {
+        BOOST_CHECK_EQUAL(sums[i], 19.875);
+    }
+    // values converted while concurrent are kept:
+    BOOST_CHECK_EQUAL(get<RECORDING_PERIOD>(md), 10u);
+    BOOST_CHECK_EQUAL(get<MUTATION_INDEL_MAX_SIZE>(md), 8);
+}
@@ -27,3 +27,76 @@ BOOST_AUTO_TEST_CASE(test_meta_population) {
 
     M.lifecycle().advance_epoch(M);
 }
+
+/*! Each subpopulation hands out identifiers from its own stream, so that no two
+ individuals in a metapopulation share an identifier.  (Selection with
+ replacement may place the same individual in a population more than once.)
+ */
+BOOST_AUTO_TEST_CASE(test_meta_population_ids) {
+    typedef metapopulation<all_ones_ea> ea_type;
+    
+    ea_type M(build_ea_md());
+    generate_initial_population(M);
+    M.lifecycle().advance_epoch(2,M);
+    BOOST_CHECK(M.size() > 1);
+    
+    std::set<individual_id_type> ids;
+    std::set<all_ones_ea::individual_type*> inds;
+    for(ea_type::iterator i=M.begin(); i!=M.end(); ++i) {
+        for(all_ones_ea::iterator j=i->begin(); j!=i->end(); ++j) {
+            BOOST_CHECK(j->id() != 0);
+            ids.insert(j->id());
+            inds.insert(&*j);
+        }
+    }
+    BOOST_CHECK(!inds.empty());
+    BOOST_CHECK_EQUAL(ids.size(), inds.size());
+}
+
+/*! Nested metapopulations carve their subpopulations' id streams out of their
+ own, so that identifiers are unique across the hierarchy, and exhausted
+ streams throw rather than wrap.
+ */
+BOOST_AUTO_TEST_CASE(test_nested_meta_population_ids) {
+    typedef metapopulation<all_ones_ea> inner_type;
+    typedef metapopulation<inner_type> outer_type;
+    
+    metadata md=build_ea_md();
+    put<METAPOPULATION_SIZE>(3,md);
+    put<POPULATION_SIZE>(8,md);
+    outer_type M(md);
+    generate_initial_population(M);
+    M.lifecycle().advance_epoch(2,M);
+    
+    std::set<individual_id_type> ids;
+    std::set<void*> inds;
+    for(outer_type::iterator i=M.begin(); i!=M.end(); ++i) {
+        for(inner_type::iterator j=i->begin(); j!=i->end(); ++j) {
+            BOOST_CHECK(j->id() != 0);
+            ids.insert(j->id());
+            inds.insert(&*j);
+            for(all_ones_ea::iterator k=j->begin(); k!=j->end(); ++k) {
+                BOOST_CHECK(k->id() != 0);
+                ids.insert(k->id());
+                inds.insert(&*k);
+            }
+        }
+    }
+    BOOST_CHECK(inds.size() > M.size()*get<METAPOPULATION_SIZE>(md));
+    BOOST_CHECK_EQUAL(ids.size(), inds.size());
+    
+    // top-level streams are exhausted after 2^24 subpopulations:
+    BOOST_CHECK_EQUAL(child_individual_id_stream(1, 0), first_individual_id(child_individual_id_stream(1, 0)) - 1);
+    BOOST_CHECK_THROW(child_individual_id_stream(1ULL << 24, 0), fatal_error_exception);
+    
+    // nested streams lie within their parent's, clear of its own identifiers:
+    individual_id_type s1=child_individual_id_stream(1, 0);
+    individual_id_type s11=child_individual_id_stream(first_individual_id(s1), s1);
+    BOOST_CHECK_EQUAL(first_individual_id(s11) >> 40, 1u);
+    BOOST_CHECK(first_individual_id(s11) > first_individual_id(s1) + 0xffff);
+    
+    // exhausted streams throw:
+    individual_id_type next=first_individual_id(s11) + (1ULL << 24) - 2;
+    BOOST_CHECK_NO_THROW(take_individual_id(next, s11));
+    BOOST_CHECK_THROW(take_individual_id(next, s11), fatal_error_exception);
+}
@@ -0,0 +1,96 @@
+/* test_nsga2.cpp
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "test.h"
+#include <ea/fitness_functions/all_ones.h>
+#include <ea/nsga2.h>
+
+
+/*! Efficient non-dominated sort should produce the same fronts as the
+ original O(MN^2) algorithm.
+ */
+BOOST_AUTO_TEST_CASE(test_nondominated_sort) {
+    default_rng_type rng(3);
+    const std::size_t N=200, M=3;
+    std::vector<double> F(N*M);
+    for(std::size_t i=0; i<F.size(); ++i) {
+        F[i] = static_cast<double>(rng(10)); // small range, so there are ties
+    }
+    
+    std::vector<std::vector<std::size_t> > fronts;
+    detail::nondominated_sort(F, M, fronts);
+    
+    // rank by peeling off non-dominated sets:
+    std::vector<int> rank(N,-1);
+    std::size_t assigned=0;
+    for(int r=0; assigned<N; ++r) {
+        std::vector<std::size_t> current;
+        for(std::size_t i=0; i<N; ++i) {
+            if(rank[i] != -1) {
+                continue;
+            }
+            bool dominated=false;
+            for(std::size_t j=0; (j<N) && !dominated; ++j) {
+                dominated = ((rank[j] == -1) && detail::dominates(&F[j*M], &F[i*M], M));
+            }
+            if(!dominated) {
+                current.push_back(i);
+            }
+        }
+        for(std::size_t i=0; i<current.size(); ++i) {
+            rank[current[i]] = r;
+        }
+        assigned += current.size();
+    }
+    
+    std::size_t n=0;
+    for(std::size_t i=0; i<fronts.size(); ++i) {
+        for(std::size_t j=0; j<fronts[i].size(); ++j) {
+            BOOST_CHECK_EQUAL(rank[fronts[i][j]], static_cast<int>(i));
+        }
+        n += fronts[i].size();
+    }
+    BOOST_CHECK_EQUAL(n, N);
+}
+
+BOOST_AUTO_TEST_CASE(test_nsga2) {
+    typedef evolutionary_algorithm
+    < direct<bitstring>
+    , multi_all_ones
+    , mutation::operators::per_site<mutation::site::bitflip>
+    , recombination::two_point_crossover
+    , generational_models::nsga2
+    , ancestors::random_bitstring
+    , dont_stop
+    , fill_population
+    , default_lifecycle
+    , nsga2_traits
+    > ea_type;
+    
+    metadata M;
+    put<POPULATION_SIZE>(100,M);
+	put<REPRESENTATION_SIZE>(10,M);
+	put<MUTATION_PER_SITE_P>(0.1,M);
+    put<CHECKPOINT_OFF>(0,M);
+    
+    ea_type ea(M);
+    generate_initial_population(ea);
+    ea.lifecycle().advance_epoch(10,ea);
+    BOOST_CHECK_EQUAL(ea.size(), 100u);
+}
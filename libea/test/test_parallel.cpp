@@ -0,0 +1,115 @@
+/* test_parallel.cpp
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "test.h"
+#include <ea/metapopulation.h>
+#include <ea/thread_pool.h>
+
+//! Stochastic fitness function, to check that parallel evaluation is reproducible.
+struct noisy_all_ones : fitness_function<unary_fitness<double>, constantS, stochasticS> {
+    template <typename Individual, typename RNG, typename EA>
+    double operator()(Individual& ind, RNG& rng, EA& ea) {
+        return static_cast<double>(std::count(ind.genome().begin(), ind.genome().end(), 1u)) + rng.p();
+    }
+};
+
+typedef evolutionary_algorithm
+< direct<bitstring>
+, noisy_all_ones
+, mutation::operators::per_site<mutation::site::bitflip>
+, recombination::two_point_crossover
+, generational_models::steady_state< >
+, ancestors::random_bitstring
+> noisy_all_ones_ea;
+
+//! Counts the number of fitness evaluations.
+template <typename EA>
+struct count_evaluations : fitness_evaluated_event<EA> {
+    count_evaluations(EA& ea) : fitness_evaluated_event<EA>(ea), n(0) { }
+    virtual ~count_evaluations() { }
+    virtual void operator()(typename EA::individual_type& ind, EA& ea) { ++n; }
+    std::size_t n;
+};
+
+//! Adds one to each element of a vector.
+struct increment {
+    increment(std::vector<int>& v) : _v(v) { }
+    void operator()(std::size_t i) { _v[i] += 1; }
+    std::vector<int>& _v;
+};
+
+BOOST_AUTO_TEST_CASE(test_parallel_for) {
+    std::vector<int> v(1000,0);
+    parallel_for(v.size(), increment(v), 4);
+    BOOST_CHECK(std::count(v.begin(), v.end(), 1) == 1000);
+    parallel_for(v.size(), increment(v), 1);
+    BOOST_CHECK(std::count(v.begin(), v.end(), 2) == 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_fitness) {
+    metadata md = build_ea_md();
+    put<RNG_SEED>(1,md);
+    put<POPULATION_SIZE>(64,md);
+    put<STEADY_STATE_LAMBDA>(16,md);
+    
+    noisy_all_ones_ea ea1(md), ea4(md);
+    put<FF_THREADS>(4,ea4);
+    generate_initial_population(ea1);
+    generate_initial_population(ea4);
+    
+    count_evaluations<noisy_all_ones_ea> c1(ea1), c4(ea4);
+    ea1.lifecycle().advance_epoch(10,ea1);
+    ea4.lifecycle().advance_epoch(10,ea4);
+    calculate_fitness(ea1.begin(), ea1.end(), ea1);
+    calculate_fitness(ea4.begin(), ea4.end(), ea4);
+    // fitness is calculated lazily on one thread and up front on more, so
+    // individuals that are replaced before selection needs their fitness are
+    // evaluated only by the latter:
+    BOOST_CHECK(c1.n <= c4.n);
+    
+    BOOST_REQUIRE_EQUAL(ea1.size(), ea4.size());
+    for(std::size_t i=0; i<ea1.size(); ++i) {
+        BOOST_CHECK(ea1[i].traits().fitness() == ea4[i].traits().fitness());
+        BOOST_CHECK_EQUAL(get<FF_RNG_SEED>(ea1[i]), get<FF_RNG_SEED>(ea4[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_metapopulation) {
+    typedef metapopulation<all_ones_ea> mea_type;
+    
+    metadata md = build_ea_md();
+    put<RNG_SEED>(1,md);
+    put<POPULATION_SIZE>(32,md);
+    
+    mea_type M1(md), M4(md);
+    put<METAPOPULATION_THREADS>(4,M4);
+    generate_initial_population(M1);
+    generate_initial_population(M4);
+    M1.lifecycle().advance_epoch(10,M1);
+    M4.lifecycle().advance_epoch(10,M4);
+    
+    BOOST_REQUIRE_EQUAL(M1.size(), M4.size());
+    for(std::size_t i=0; i<M1.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(M1[i].size(), M4[i].size());
+        BOOST_CHECK_EQUAL(M1[i].current_update(), M4[i].current_update());
+        for(std::size_t j=0; j<M1[i].size(); ++j) {
+            BOOST_CHECK(M1[i][j].genome() == M4[i][j].genome());
+        }
+    }
+}
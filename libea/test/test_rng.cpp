@@ -22,6 +22,7 @@
 #include <boost/archive/xml_iarchive.hpp>
 
 #include <ea/rng.h>
+#include <ea/thread_pool.h>
 #include "test.h"
 
 BOOST_AUTO_TEST_CASE(rng_functional) {
@@ -61,3 +62,163 @@ BOOST_AUTO_TEST_CASE(rng_serialization) {
 		BOOST_CHECK_EQUAL(rng1.bit(), rng2.bit());
 	}	
 }
+
+BOOST_AUTO_TEST_CASE(rng_engines) {
+	using namespace ealib;
+    
+    // known answers from the reference implementations:
+    xoshiro256ss x(1,2,3,4);
+    BOOST_CHECK_EQUAL(x(), 11520ULL);
+    BOOST_CHECK_EQUAL(x(), 0ULL);
+    BOOST_CHECK_EQUAL(x(), 1509978240ULL);
+    BOOST_CHECK_EQUAL(x(), 1215971899390074240ULL);
+    
+    pcg64 p(42,54);
+    BOOST_CHECK_EQUAL(p(), 0x86b1da1d72062b68ULL);
+    BOOST_CHECK_EQUAL(p(), 0x1304aa46c9853d39ULL);
+    BOOST_CHECK_EQUAL(p(), 0xa3670e9e0dd50358ULL);
+    
+    philox4x32::result_type ctr[4]={0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}, key[2]={0xa4093822,0x299f31d0}, out[4];
+    philox4x32::block(ctr, key, out);
+    BOOST_CHECK_EQUAL(out[0], 0xd16cfe09u);
+    BOOST_CHECK_EQUAL(out[1], 0x94fdccebu);
+    BOOST_CHECK_EQUAL(out[2], 0x5001e420u);
+    BOOST_CHECK_EQUAL(out[3], 0x24126ea1u);
+    philox4x32 c(0,0);
+    BOOST_CHECK_EQUAL(c(), 0x6627e8d5u);
+    BOOST_CHECK_EQUAL(c(), 0xe169c58du);
+}
+
+template <typename RNG>
+void check_rng_state(unsigned int seed) {
+    RNG rng1(seed), rng2(seed+1);
+    rng1.p();
+    
+    // save and restore mid-block:
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << BOOST_SERIALIZATION_NVP(rng1);
+    }
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive ia(in);
+        ia >> BOOST_SERIALIZATION_NVP(rng2);
+    }
+    BOOST_CHECK(rng1 == rng2);
+    for(int i=0; i<100; ++i) {
+        BOOST_CHECK_EQUAL(rng1(1000), rng2(1000));
+    }
+    
+    // bulk fills match repeated calls:
+    std::vector<double> u(64), n(64);
+    std::vector<int> b(64);
+    rng1.fill_uniform(u.begin(), u.end(), -1.0, 1.0);
+    rng1.fill_bernoulli(b.begin(), b.end(), 0.25);
+    rng1.fill_normal(n.begin(), n.end(), 0.0, 1.0);
+    for(std::size_t i=0; i<u.size(); ++i) {
+        BOOST_CHECK_EQUAL(u[i], rng2.uniform_real(-1.0, 1.0));
+        BOOST_CHECK((u[i] >= -1.0) && (u[i] < 1.0));
+    }
+    for(std::size_t i=0; i<b.size(); ++i) {
+        BOOST_CHECK_EQUAL(b[i], rng2.p(0.25));
+    }
+    for(std::size_t i=0; i<n.size(); ++i) {
+        BOOST_CHECK_EQUAL(n[i], rng2.normal_real(0.0, 1.0));
+    }
+    for(int i=0; i<1000; ++i) {
+        int r=rng1(3,7);
+        BOOST_CHECK((r >= 3) && (r < 7));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rng_engine_types) {
+	using namespace ealib;
+    check_rng_state<default_rng_type>(1);
+    check_rng_state<xoshiro_rng_type>(1);
+    check_rng_state<pcg_rng_type>(1);
+    check_rng_state<philox_rng_type>(1);
+}
+
+//! Draws a few numbers from stream i.
+struct stream_task {
+    stream_task(const ealib::rng_streams& s, std::vector<int>& v) : _s(s), _v(v) { }
+    void operator()(std::size_t i) {
+        ealib::rng_streams::rng_type rng=_s(7, i, 3);
+        rng(100);
+        _v[i] = rng(1000000);
+    }
+    const ealib::rng_streams& _s;
+    std::vector<int>& _v;
+};
+
+BOOST_AUTO_TEST_CASE(rng_stream_keys) {
+	using namespace ealib;
+    rng_streams s(42);
+    
+    // streams depend only on their keys:
+    rng_streams::rng_type a=s(1,2,3), b=s(1,2,3);
+    for(int i=0; i<100; ++i) {
+        BOOST_CHECK_EQUAL(a(1000), b(1000));
+    }
+    
+    // and differ when any part of the key differs:
+    rng_streams::rng_type c=s(1,2,3), d=s(2,2,3), e=s(1,3,3), f=s(1,2,4), g=rng_streams(43)(1,2,3);
+    int same=0;
+    for(int i=0; i<100; ++i) {
+        int x=c();
+        same += (x == d()) + (x == e()) + (x == f()) + (x == g());
+    }
+    BOOST_CHECK_EQUAL(same, 0);
+    
+    // an id's high bits are part of the key:
+    rng_streams::rng_type h=s(1,(1ULL<<32)+2,3), k=s(1,2,3);
+    BOOST_CHECK(h() != k());
+    
+    // results are the same regardless of the number of threads:
+    std::vector<int> v1(256), v4(256);
+    parallel_for(v1.size(), stream_task(s,v1), 1);
+    parallel_for(v4.size(), stream_task(s,v4), 4);
+    BOOST_CHECK(v1 == v4);
+    
+    // the master seed is serialized:
+    rng_streams s2;
+    std::ostringstream out;
+    {
+        boost::archive::xml_oarchive oa(out);
+        oa << BOOST_SERIALIZATION_NVP(s);
+    }
+    std::istringstream in(out.str());
+    {
+        boost::archive::xml_iarchive ia(in);
+        ia >> BOOST_SERIALIZATION_NVP(s2);
+    }
+    BOOST_CHECK_EQUAL(s2.seed(), 42u);
+    BOOST_CHECK_EQUAL(s2(5,6,7)(), s(5,6,7)());
+}
+
+BOOST_AUTO_TEST_CASE(rng_stream_ea) {
+	using namespace ealib;
+    all_ones_ea ea(build_ea_md());
+    put<RNG_SEED>(11,ea);
+    default_rng_type before(ea.rng());
+    
+    rng_streams::rng_type a=rng_stream(5, 1, ea);
+    BOOST_CHECK_EQUAL(a(), rng_streams(11)(ea.current_update(), 5, 1)());
+    BOOST_CHECK(before == ea.rng()); // ea.rng() is untouched
+}
+
+BOOST_AUTO_TEST_CASE(rng_clock_seed) {
+	using namespace ealib;
+    metadata md=build_ea_md();
+    put<RNG_SEED>(0,md);
+    all_ones_ea ea(md);
+    
+    // a seed of 0 seeds from the clock, and the seed that was used is recorded:
+    BOOST_CHECK(get<RNG_SEED>(ea) != 0u);
+    BOOST_CHECK(default_rng_type(get<RNG_SEED>(ea)) == ea.rng());
+    
+    ea.reset_rng(0);
+    BOOST_CHECK(get<RNG_SEED>(ea) != 0u);
+    BOOST_CHECK(default_rng_type(get<RNG_SEED>(ea)) == ea.rng());
+}
@@ -0,0 +1,198 @@
+/* test_selection.cpp
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "test.h"
+#include <ea/selection/tournament.h>
+#include <ea/selection/proportionate.h>
+#include <ea/selection/universal_sampling.h>
+#include <ea/selection/truncation.h>
+#include <ea/selection/rank.h>
+#include <ea/selection/elitism.h>
+#include <ea/selection/random.h>
+
+
+//! Builds a population of n individuals with fitnesses 0..n-1.
+void build_ranked_population(std::size_t n, all_ones_ea& ea) {
+    for(std::size_t i=0; i<n; ++i) {
+        all_ones_ea::individual_ptr_type p=ea.make_individual();
+        p->traits().fitness() = static_cast<double>(i);
+        ea.population().push_back(p);
+    }
+}
+
+/*! Tournament selection picks each individual with the probability that it is
+ the best of a random tournament.
+ */
+BOOST_AUTO_TEST_CASE(test_tournament_selection) {
+    all_ones_ea ea(build_ea_md());
+    build_ranked_population(4, ea);
+    
+    // N=2, K=1: the individual with rank r (0=worst) wins with probability r/6:
+    put<TOURNAMENT_SELECTION_N>(2,ea);
+    put<TOURNAMENT_SELECTION_K>(1,ea);
+    all_ones_ea::population_type dst;
+    selection::tournament< > t(6000, ea.population(), ea);
+    t(ea.population(), dst, 6000, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 6000u);
+    
+    std::vector<int> counts(4,0);
+    for(std::size_t i=0; i<dst.size(); ++i) {
+        ++counts[static_cast<std::size_t>(dst[i]->traits().fitness())];
+    }
+    BOOST_CHECK_EQUAL(counts[0], 0);
+    BOOST_CHECK(std::abs(counts[1]-1000) < 150);
+    BOOST_CHECK(std::abs(counts[2]-2000) < 150);
+    BOOST_CHECK(std::abs(counts[3]-3000) < 150);
+    
+    // N=4, K=2: the two best always win, best first:
+    put<TOURNAMENT_SELECTION_N>(4,ea);
+    put<TOURNAMENT_SELECTION_K>(2,ea);
+    dst.clear();
+    t(ea.population(), dst, 5, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 5u);
+    for(std::size_t i=0; i<dst.size(); ++i) {
+        BOOST_CHECK_EQUAL(static_cast<double>(dst[i]->traits().fitness()), (i%2) ? 2.0 : 3.0);
+    }
+}
+
+/*! The alias table draws each index with probability proportional to its weight.
+ */
+BOOST_AUTO_TEST_CASE(test_alias_table) {
+    default_rng_type rng(1);
+    double w[] = {1.0, 2.0, 3.0, 4.0, 0.0};
+    alias_table t;
+    t.build(w, w+5);
+    BOOST_CHECK_EQUAL(t.size(), 5u);
+    
+    std::vector<int> counts(5,0);
+    for(int i=0; i<10000; ++i) {
+        ++counts[t(rng)];
+    }
+    BOOST_CHECK(std::abs(counts[0]-1000) < 150);
+    BOOST_CHECK(std::abs(counts[1]-2000) < 150);
+    BOOST_CHECK(std::abs(counts[2]-3000) < 150);
+    BOOST_CHECK(std::abs(counts[3]-4000) < 150);
+    BOOST_CHECK_EQUAL(counts[4], 0);
+}
+
+/*! Alias-method and stochastic universal sampling select individuals in
+ proportion to their fitness.
+ */
+BOOST_AUTO_TEST_CASE(test_proportionate_selection) {
+    all_ones_ea ea(build_ea_md());
+    build_ranked_population(4, ea);
+    
+    // alias method; fitness 0 is never selected:
+    all_ones_ea::population_type dst;
+    selection::alias_proportionate< > ap(6000, ea.population(), ea);
+    ap(ea.population(), dst, 6000, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 6000u);
+    std::vector<int> counts(4,0);
+    for(std::size_t i=0; i<dst.size(); ++i) {
+        ++counts[static_cast<std::size_t>(dst[i]->traits().fitness())];
+    }
+    BOOST_CHECK_EQUAL(counts[0], 0);
+    BOOST_CHECK(std::abs(counts[1]-1000) < 150);
+    BOOST_CHECK(std::abs(counts[2]-2000) < 150);
+    BOOST_CHECK(std::abs(counts[3]-3000) < 150);
+    
+    // sus; with expected counts that are integers, they're met exactly:
+    for(int k=0; k<10; ++k) {
+        dst.clear();
+        selection::universal_sampling< > sus(6, ea.population(), ea);
+        sus(ea.population(), dst, 6, ea);
+        BOOST_CHECK_EQUAL(dst.size(), 6u);
+        std::fill(counts.begin(), counts.end(), 0);
+        for(std::size_t i=0; i<dst.size(); ++i) {
+            ++counts[static_cast<std::size_t>(dst[i]->traits().fitness())];
+        }
+        BOOST_CHECK_EQUAL(counts[0], 0);
+        BOOST_CHECK_EQUAL(counts[1], 1);
+        BOOST_CHECK_EQUAL(counts[2], 2);
+        BOOST_CHECK_EQUAL(counts[3], 3);
+    }
+    
+    // if all fitnesses are 0, selection is uniform:
+    for(std::size_t i=0; i<ea.population().size(); ++i) {
+        ea.population()[i]->traits().fitness() = 0.0;
+    }
+    dst.clear();
+    selection::universal_sampling< > sus(8, ea.population(), ea);
+    sus(ea.population(), dst, 8, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 8u);
+    for(std::size_t i=0; i<ea.population().size(); ++i) {
+        BOOST_CHECK_EQUAL(std::count(dst.begin(), dst.end(), ea.population()[i]), 2);
+    }
+    dst.clear();
+    selection::alias_proportionate< > ap0(4000, ea.population(), ea);
+    ap0(ea.population(), dst, 4000, ea);
+    for(std::size_t i=0; i<ea.population().size(); ++i) {
+        BOOST_CHECK(std::abs(std::count(dst.begin(), dst.end(), ea.population()[i])-1000) < 150);
+    }
+}
+
+/*! Truncation, rank and elitism select the most-fit individuals, most-fit first,
+ breaking ties by position and leaving the source population unmodified.
+ */
+BOOST_AUTO_TEST_CASE(test_truncation_selection) {
+    all_ones_ea ea(build_ea_md());
+    build_ranked_population(6, ea);
+    all_ones_ea::population_type& src=ea.population();
+    src[1]->traits().fitness() = 4.0; // ties with src[4]
+    std::vector<all_ones_ea::individual_ptr_type> original(src.begin(), src.end());
+    
+    all_ones_ea::population_type dst;
+    selection::truncation t(3, src, ea);
+    t(src, dst, 3, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 3u);
+    BOOST_CHECK(dst[0] == src[5]);
+    BOOST_CHECK(dst[1] == src[1]);
+    BOOST_CHECK(dst[2] == src[4]);
+    BOOST_CHECK(std::equal(original.begin(), original.end(), src.begin()));
+    
+    dst.clear();
+    selection::rank< > r(4, src, ea);
+    r(src, dst, 4, ea);
+    BOOST_CHECK_EQUAL(dst.size(), 4u);
+    BOOST_CHECK(dst[0] == src[5]);
+    BOOST_CHECK(dst[1] == src[1]);
+    BOOST_CHECK(dst[2] == src[4]);
+    BOOST_CHECK(dst[3] == src[3]);
+    BOOST_CHECK(std::equal(original.begin(), original.end(), src.begin()));
+    
+    // elites are appended after those selected by the embedded strategy:
+    put<ELITISM_N>(2, ea);
+    dst.clear();
+    selection::elitism<selection::random<> > e(5, src, ea);
+    for(int i=0; i<3; ++i) {
+        e(src, dst, 5, ea);
+        BOOST_CHECK_EQUAL(dst.size(), 5u*(i+1));
+        BOOST_CHECK(dst[dst.size()-2] == src[5]);
+        BOOST_CHECK(dst[dst.size()-1] == src[1]);
+    }
+    BOOST_CHECK(std::equal(original.begin(), original.end(), src.begin()));
+    
+    // ...and found anew if the population changes between calls, even if its
+    // size does not:
+    src[0]->traits().fitness() = 10.0;
+    dst.clear();
+    e(src, dst, 5, ea);
+    BOOST_CHECK(dst[dst.size()-2] == src[0]);
+    BOOST_CHECK(dst[dst.size()-1] == src[5]);
+}
@@ -43,7 +43,34 @@ BOOST_AUTO_TEST_CASE(test_checkpoint) {
     // check that the individuals in ea1 are pretty much the same as the individuals in ea2:
     for(all_ones_ea::iterator i=ea1.begin(), j=ea2.begin(); i!=ea1.end(); ++i, ++j) {
         BOOST_CHECK(ealib::fitness(*i,ea1) == ealib::fitness(*j,ea2));
-        BOOST_CHECK(get<IND_UNIQUE_NAME>(*i) == get<IND_UNIQUE_NAME>(*j));
+        BOOST_CHECK(i->id() == j->id());
+    }
+}
+
+/*! Test of binary and compressed checkpoints, which are detected on load.
+ */
+BOOST_AUTO_TEST_CASE(test_checkpoint_formats) {
+    all_ones_ea ea1(build_ea_md());
+    generate_initial_population(ea1);
+    ea1.lifecycle().advance_epoch(10,ea1);
+    
+    checkpoint::archive_format fmts[] = { checkpoint::xml_format, checkpoint::binary_format };
+    for(std::size_t f=0; f<2; ++f) {
+        for(int compress=0; compress<2; ++compress) {
+            std::ostringstream out;
+            checkpoint::save(out, ea1, fmts[f], compress);
+            
+            all_ones_ea ea2;
+            std::istringstream in(out.str());
+            checkpoint::load(in, ea2);
+            
+            BOOST_CHECK_EQUAL(ea1.size(), ea2.size());
+            BOOST_CHECK(ea1.rng() == ea2.rng());
+            for(all_ones_ea::iterator i=ea1.begin(), j=ea2.begin(); i!=ea1.end(); ++i, ++j) {
+                BOOST_CHECK(i->genome() == j->genome());
+                BOOST_CHECK(i->id() == j->id());
+            }
+        }
     }
 }
 
@@ -58,11 +85,43 @@ BOOST_AUTO_TEST_CASE(test_replicability) {
     // check that the individuals in ea1 are pretty much the same as the individuals in ea2:
     for(all_ones_ea::iterator i=ea1.begin(), j=ea2.begin(); i!=ea1.end(); ++i, ++j) {
         BOOST_CHECK(ealib::fitness(*i,ea1) == ealib::fitness(*j,ea2));
-        BOOST_CHECK(get<IND_UNIQUE_NAME>(*i) == get<IND_UNIQUE_NAME>(*j));
+        BOOST_CHECK(i->id() == j->id());
         BOOST_CHECK(ea1.rng() == ea2.rng());
     }
 }
 
+/*! Individuals are given increasing identifiers at birth, and an EA's next
+ identifier is restored from checkpoints.
+ */
+BOOST_AUTO_TEST_CASE(test_individual_ids) {
+    all_ones_ea ea1(build_ea_md()), ea2;
+    generate_initial_population(ea1);
+    
+    std::set<individual_id_type> ids;
+    for(all_ones_ea::iterator i=ea1.begin(); i!=ea1.end(); ++i) {
+        BOOST_CHECK(i->id() != 0);
+        ids.insert(i->id());
+        BOOST_CHECK_EQUAL(unique_name(*i), boost::lexical_cast<std::string>(i->id()));
+    }
+    BOOST_CHECK_EQUAL(ids.size(), ea1.size());
+    
+    // saving doesn't modify meta-data:
+    std::ostringstream out;
+    checkpoint::save(out, ea1);
+    BOOST_CHECK(!exists<NEXT_INDIVIDUAL_ID>(ea1));
+    BOOST_CHECK(!exists<IND_UNIQUE_NAME>(*ea1.begin()));
+    
+    std::istringstream in(out.str());
+    checkpoint::load(in, ea2);
+    BOOST_REQUIRE_EQUAL(ea2.size(), ea1.size());
+    for(std::size_t i=0; i<ea1.size(); ++i) {
+        BOOST_CHECK_EQUAL(ea2[i].id(), ea1[i].id());
+    }
+    individual_id_type next=ea1.next_individual_id();
+    BOOST_CHECK(next > *ids.rbegin());
+    BOOST_CHECK_EQUAL(ea2.next_individual_id(), next);
+}
+
 /*! Test of EA archiving.
  */
 BOOST_AUTO_TEST_CASE(test_archive) {
@@ -80,6 +139,6 @@ BOOST_AUTO_TEST_CASE(test_archive) {
     // check that the individuals in ea1 are pretty much the same as the individuals in ea2:
     for(all_ones_ea::iterator i=ea1.begin(), j=ea2.begin(); i!=ea1.end(); ++i, ++j) {
         BOOST_CHECK(ealib::fitness(*i,ea1) == ealib::fitness(*j,ea2));
-        BOOST_CHECK(get<IND_UNIQUE_NAME>(*i) == get<IND_UNIQUE_NAME>(*j));
+        BOOST_CHECK(i->id() == j->id());
     }
 }
@@ -17,9 +17,13 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <numeric>
 #include <boost/test/unit_test.hpp>
 #include <ea/algorithm.h>
 #include <ea/data_structures/circular_vector.h>
+#include <ea/data_structures/fenwick_tree.h>
+#include <ea/data_structures/ring_buffer.h>
+#include <ea/data_structures/small_deque.h>
 #include <ea/data_structures/torus.h>
 
 BOOST_AUTO_TEST_CASE(test_torus1) {
@@ -199,3 +203,105 @@ BOOST_AUTO_TEST_CASE(test_circular_vector) {
     std::advance(i, 3*cv.size());
     BOOST_CHECK((*i)==(255-44));
 }
+
+BOOST_AUTO_TEST_CASE(test_ring_buffer) {
+    using namespace ealib;
+    typedef ring_buffer<int,3> rb_type;
+    rb_type rb;
+    BOOST_CHECK(rb.empty());
+    
+    // pushing onto a full buffer drops the element at the other end:
+    rb.push_back(1); rb.push_back(2); rb.push_back(3);
+    BOOST_CHECK(rb.full());
+    rb.push_back(4);
+    int e1[] = {2, 3, 4};
+    BOOST_CHECK(std::equal(rb.begin(), rb.end(), e1));
+    rb.push_front(5);
+    int e2[] = {5, 2, 3};
+    BOOST_CHECK(std::equal(rb.begin(), rb.end(), e2));
+    BOOST_CHECK_EQUAL(rb.back(), 3);
+    
+    // copies are independent:
+    rb_type c(rb);
+    c.pop_front();
+    BOOST_CHECK(c != rb);
+    c.push_front(5);
+    BOOST_CHECK(c == rb);
+    
+    rb.resize(1);
+    BOOST_CHECK_EQUAL(rb.size(), 1u);
+    BOOST_CHECK_EQUAL(rb.front(), 5);
+    rb.resize(10, 7);
+    BOOST_CHECK_EQUAL(rb.size(), 3u);
+    BOOST_CHECK_EQUAL(rb[2], 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_small_deque) {
+    using namespace ealib;
+    typedef small_deque<int,3> sd_type;
+    sd_type sd;
+    BOOST_CHECK(sd.empty());
+    
+    // elements beyond the inline capacity are kept, in order:
+    for(int i=0; i<5; ++i) {
+        sd.push_back(i);
+    }
+    BOOST_CHECK_EQUAL(sd.size(), 5u);
+    for(int i=0; i<5; ++i) {
+        BOOST_CHECK_EQUAL(sd[i], i);
+    }
+    
+    // copies are independent:
+    sd_type c(sd);
+    c.pop_front();
+    BOOST_CHECK(c != sd);
+    BOOST_CHECK_EQUAL(c.front(), 1);
+    BOOST_CHECK_EQUAL(c[3], 4);
+    
+    for(int i=0; i<5; ++i) {
+        BOOST_CHECK_EQUAL(sd.front(), i);
+        sd.pop_front();
+    }
+    BOOST_CHECK(sd.empty());
+    sd.push_back(7);
+    BOOST_CHECK_EQUAL(sd.size(), 1u);
+    BOOST_CHECK_EQUAL(sd.front(), 7);
+    c.clear();
+    BOOST_CHECK(c.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_fenwick_tree) {
+    using namespace ealib;
+    fenwick_tree<int> t;
+    std::vector<int> w;
+    BOOST_CHECK_EQUAL(t.sum(), 0);
+    BOOST_CHECK_EQUAL(t.find(0), 0u);
+    
+    // appended and changed weights are reflected in prefix sums:
+    for(int i=0; i<13; ++i) {
+        t.push_back(i % 3);
+        w.push_back(i % 3);
+    }
+    t.set(4, 5); w[4] = 5;
+    t.set(12, 0); w[12] = 0;
+    for(std::size_t n=0; n<=w.size(); ++n) {
+        BOOST_CHECK_EQUAL(t.prefix(n), std::accumulate(w.begin(), w.begin()+n, 0));
+    }
+    
+    // find returns the element covering each cumulative weight, skipping
+    // zero weights:
+    std::size_t j=0;
+    for(int s=0; s<t.sum(); ++s) {
+        while(std::accumulate(w.begin(), w.begin()+j+1, 0) <= s) {
+            ++j;
+        }
+        BOOST_CHECK_EQUAL(t.find(s), j);
+    }
+    BOOST_CHECK_EQUAL(t.find(t.sum()), t.size());
+    
+    fenwick_tree<int> u;
+    u.assign(w.begin(), w.end());
+    for(std::size_t n=0; n<=w.size(); ++n) {
+        BOOST_CHECK_EQUAL(u.prefix(n), t.prefix(n));
+    }
+}
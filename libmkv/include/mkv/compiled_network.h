@@ -0,0 +1,379 @@
+/* compiled_network.h
+ *
+ * This file is part of EALib.
+ *
+ * Copyright 2014 David B. Knoester.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef _MKV_COMPILED_NETWORK_H_
+#define _MKV_COMPILED_NETWORK_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <ea/algorithm.h>
+#include <ea/exceptions.h>
+#include <mkv/markov_network.h>
+
+namespace mkv {
+
+    /*! Compiled Markov network.
+
+     A compiled network is a flattened copy of a (translated) markov_network,
+     intended for fast, repeated updates.  Gate inputs, outputs, and tables are
+     held in contiguous structure-of-arrays buffers, and gates are dispatched
+     with a switch on their type rather than a virtual call.  Updates perform
+     no heap allocation.
+
+     Updates produce exactly the same state (including rng draws and adaptive
+     gate learning) as the markov_network that the compiled network was built
+     from.  The compiled network is independent of that network once built:
+     it has its own copy of the state vector, rng, and adaptive gate state.
+     */
+    template <typename StateType=int
+    , typename UpdateFunction=ealib::binary_or<StateType>
+    , typename InputFunction=ealib::non_zero<StateType>
+    , typename RandomNumberGenerator=ealib::default_rng_type
+    > class compiled_markov_network {
+    public:
+        typedef StateType state_type; //!< State variable type.
+        typedef std::vector<state_type> state_vector_type; //!< State vector type.
+        typedef state_type* iterator; //!< Type for iterators over state variables.
+        typedef UpdateFunction update_function_type; //!< Binary function that updates state variables.
+        typedef InputFunction input_function_type; //!< Unary function that calculates the value of an input.
+        typedef RandomNumberGenerator rng_type; //!< Random number generator type.
+        typedef markov_network<StateType,UpdateFunction,InputFunction,RandomNumberGenerator> markov_network_type; //!< Type of network that can be compiled.
+
+        //! Gate types understood by the compiled network.
+        enum gate_kind { LOGIC, PROBABILISTIC, ADAPTIVE };
+
+        //! Default constructor.
+        compiled_markov_network() : _nin(0), _nout(0), _nhid(0) {
+            _in_begin.push_back(0);
+            _out_begin.push_back(0);
+        }
+
+        //! Constructor; compiles the given Markov network.
+        compiled_markov_network(const markov_network_type& N) {
+            compile(N);
+        }
+
+        //! Compile the given Markov network, replacing any existing contents.
+        void compile(const markov_network_type& N) {
+            typedef mkv::abstract_gate<rng_type> abstract_gate_type;
+            typedef mkv::logic_gate<rng_type> logic_gate_type;
+            typedef mkv::probabilistic_gate<rng_type> probabilistic_gate_type;
+            typedef mkv::adaptive_gate<rng_type> adaptive_gate_type;
+
+            _nin = N.ninputs();
+            _nout = N.noutputs();
+            _nhid = N.nhidden();
+            _rng = N.rng();
+            _T.resize(N.nstates());
+            for(std::size_t i=0; i<N.nstates(); ++i) {
+                _T[i] = N(i);
+            }
+            _Tplus1.assign(N.nstates(), state_type());
+
+            _kind.clear(); _in_begin.assign(1,0); _in.clear(); _out_begin.assign(1,0); _out.clear();
+            _table.clear(); _ncols.clear(); _adaptive.clear();
+            _logic.clear(); _prob.clear();
+            _a_disabled.clear(); _a_h.clear(); _a_q.clear(); _a_qsize.clear(); _a_P.clear(); _a_np.clear(); _a_N.clear(); _a_nn.clear();
+            _a_hist.clear(); _a_hist_cap.clear(); _a_hist_head.clear(); _a_hist_size.clear();
+            _q.clear(); _weights.clear(); _hist_x.clear(); _hist_y.clear();
+
+            for(std::size_t g=0; g<N.ngates(); ++g) {
+                const abstract_gate_type& gate=N[g];
+
+                _in.insert(_in.end(), gate.inputs.begin(), gate.inputs.end());
+                _in_begin.push_back(_in.size());
+                _out.insert(_out.end(), gate.outputs.begin(), gate.outputs.end());
+                _out_begin.push_back(_out.size());
+
+                if(const logic_gate_type* p=dynamic_cast<const logic_gate_type*>(&gate)) {
+                    _kind.push_back(LOGIC);
+                    _table.push_back(_logic.size());
+                    _ncols.push_back(0);
+                    _adaptive.push_back(0);
+                    _logic.insert(_logic.end(), p->M.begin(), p->M.end());
+                } else if(const probabilistic_gate_type* p=dynamic_cast<const probabilistic_gate_type*>(&gate)) {
+                    _kind.push_back(PROBABILISTIC);
+                    _table.push_back(_prob.size());
+                    _ncols.push_back(p->M.size2());
+                    _adaptive.push_back(0);
+                    append_matrix(p->M, _prob);
+                } else if(const adaptive_gate_type* p=dynamic_cast<const adaptive_gate_type*>(&gate)) {
+                    _kind.push_back(ADAPTIVE);
+                    _table.push_back(_prob.size());
+                    _ncols.push_back(p->M.size2());
+                    _adaptive.push_back(_a_h.size());
+                    append_matrix(p->M, _prob);
+
+                    _a_disabled.push_back(p->_disabled);
+                    _a_h.push_back(p->h);
+                    _a_q.push_back(_q.size());
+                    append_matrix(p->Q, _q);
+                    _a_qsize.push_back(_q.size() - _a_q.back());
+                    _a_P.push_back(_weights.size());
+                    _a_np.push_back(p->P.size());
+                    _weights.insert(_weights.end(), p->P.begin(), p->P.end());
+                    _a_N.push_back(_weights.size());
+                    _a_nn.push_back(p->N.size());
+                    _weights.insert(_weights.end(), p->N.begin(), p->N.end());
+
+                    // history is a ring buffer; it never holds more than h+1 entries:
+                    std::size_t cap=std::max(p->h+1, p->H.size());
+                    _a_hist.push_back(_hist_x.size());
+                    _a_hist_cap.push_back(cap);
+                    _a_hist_head.push_back(0);
+                    _a_hist_size.push_back(p->H.size());
+                    for(std::size_t i=0; i<cap; ++i) {
+                        _hist_x.push_back(i<p->H.size() ? p->H[i].first : 0);
+                        _hist_y.push_back(i<p->H.size() ? p->H[i].second : 0);
+                    }
+                } else {
+                    throw ealib::bad_argument_exception("compiled_markov_network: unknown gate type.");
+                }
+            }
+        }
+
+        //! Clears this network (resets all state variables and adaptive gates).
+        void clear() {
+            std::fill(_T.begin(), _T.end(), state_type());
+            std::fill(_Tplus1.begin(), _Tplus1.end(), state_type());
+            for(std::size_t g=0; g<_kind.size(); ++g) {
+                if(_kind[g] == ADAPTIVE) {
+                    std::size_t a=_adaptive[g];
+                    _a_hist_head[a] = 0;
+                    _a_hist_size[a] = 0;
+                    std::copy(_q.begin()+_a_q[a], _q.begin()+_a_q[a]+_a_qsize[a], _prob.begin()+_table[g]);
+                }
+            }
+        }
+
+        //! Disables adaptation of gate logic.
+        void disable_adaptation() {
+            std::fill(_a_disabled.begin(), _a_disabled.end(), 1);
+        }
+
+        //! Reset this network's rng.
+        void reset(unsigned int seed) {
+            _rng.reset(seed);
+        }
+
+        //! Retrieve this network's rng.
+        rng_type& rng() { return _rng; }
+
+        //! Retrieve the size of this network, in number of gates.
+        std::size_t ngates() const { return _kind.size(); }
+
+        //! Retrieve the number of state variables in this network.
+        std::size_t nstates() const { return _T.size(); }
+
+        //! Retrieve the number of inputs to this network.
+        std::size_t ninputs() const { return _nin; }
+
+        //! Retrieve the number of outputs from this network.
+        std::size_t noutputs() const { return _nout; }
+
+        //! Retrieve the number of hiddenn state variables in this network.
+        std::size_t nhidden() const { return _nhid; }
+
+        //! Retrieve state variable i.
+        state_type& operator()(std::size_t i) { return _T[i]; }
+
+        //! Retrieve state variable i (const-qualified).
+        const state_type& operator()(std::size_t i) const { return _T[i]; }
+
+        //! Retrieve input state variable i.
+        state_type& input(std::size_t i) { return _T[i]; }
+
+        //! Retrieve output state variable i.
+        state_type& output(std::size_t i) { return _T[_nin+i]; }
+
+        //! Retrieve hidden state variable i.
+        state_type& hidden(std::size_t i) { return _T[_nin+_nout+i]; }
+
+        //! Retrieve an iterator to the beginning of the inputs.
+        iterator begin_input() { return &_T[0]; }
+
+        //! Retrieve an iterator to the end of the inputs.
+        iterator end_input() { return &_T[0] + _nin; }
+
+        //! Retrieve an iterator to the beginning of the outputs.
+        iterator begin_output() { return &_T[0] + _nin; }
+
+        //! Retrieve an iterator to the end of the outputs.
+        iterator end_output() { return &_T[0] + _nin + _nout; }
+
+        //! Retrieve an iterator to the beginning of the hidden states.
+        iterator begin_hidden() { return &_T[0] + _nin + _nout; }
+
+        //! Retrieve an iterator to the end of the hidden states.
+        iterator end_hidden() { return &_T[0] + _nin + _nout + _nhid; }
+
+        /*! Zero-copy update; see markov_network::update.
+
+         \param f is any type that supports operator[] (e.g., RA iterator or sequence).
+         */
+        template <typename RandomAccess>
+        void update(RandomAccess f, std::size_t n=1) {
+            for( ; n>0; --n) {
+                for(std::size_t g=0; g<_kind.size(); ++g) {
+                    // calculate the input to this gate
+                    state_type x=0;
+                    for(std::size_t j=_in_begin[g], b=_in_begin[g]; j<_in_begin[g+1]; ++j) {
+                        std::size_t k=_in[j];
+                        if(k<_nin) {
+                            x = _uf(x, (_if(f[k]) << (j-b)));
+                        } else {
+                            x = _uf(x, (_if(_T[k]) << (j-b)));
+                        }
+                    }
+
+                    // calculate the output:
+                    state_type y;
+                    switch(_kind[g]) {
+                        case LOGIC: y = _logic[_table[g] + x]; break;
+                        case PROBABILISTIC: y = sample(&_prob[_table[g] + x*_ncols[g]], _ncols[g]); break;
+                        case ADAPTIVE: default: y = adapt(g, x); break;
+                    }
+
+                    // set the output from this gate:
+                    for(std::size_t j=_out_begin[g], b=_out_begin[g]; j<_out_begin[g+1]; ++j) {
+                        state_type& t = _Tplus1[_out[j]];
+                        t = _uf(t, ((y>>(j-b)) & 0x01));
+                    }
+                }
+            }
+            std::swap(_T,_Tplus1);
+            std::fill(_Tplus1.begin(), _Tplus1.end(), state_type()); // have to clear tplus1 (OR logic on output)
+        }
+
+        //! Update this Markov network n times, assuming all inputs have been set.
+        void update(std::size_t n=1) {
+            update(_T.begin(), n);
+        }
+
+    protected:
+        //! Append the rows of matrix M to buffer b.
+        template <typename Matrix>
+        void append_matrix(const Matrix& M, std::vector<double>& b) {
+            for(std::size_t i=0; i<M.size1(); ++i) {
+                for(std::size_t j=0; j<M.size2(); ++j) {
+                    b.push_back(M(i,j));
+                }
+            }
+        }
+
+        //! Select a column from the given probability row.
+        int sample(const double* row, std::size_t ncols) {
+            double p = _rng.p();
+            for(int j=0; j<static_cast<int>(ncols); ++j) {
+                if(p <= row[j]) {
+                    return j;
+                }
+                p -= row[j];
+            }
+            // floating point precision problem; default to the final column:
+            return ncols-1;
+        }
+
+        //! Scale the probability of output (i,j) of gate g by s.
+        void scale(std::size_t g, std::size_t i, std::size_t j, double s) {
+            double* row=&_prob[_table[g] + i*_ncols[g]];
+            row[j] *= 1.0 + s;
+            ealib::algorithm::normalize(row, row+_ncols[g], row, 1.0);
+        }
+
+        //! Update adaptive gate g on input x; see adaptive_gate::operator().
+        int adapt(std::size_t g, state_type x) {
+            std::size_t a=_adaptive[g];
+            std::size_t* hx=&_hist_x[_a_hist[a]];
+            int* hy=&_hist_y[_a_hist[a]];
+            std::size_t cap=_a_hist_cap[a];
+            std::size_t& head=_a_hist_head[a];
+            std::size_t& size=_a_hist_size[a];
+
+            while(size > _a_h[a]) { // prune history
+                head = (head+1) % cap;
+                --size;
+            }
+
+            if(!_a_disabled[a]) {
+                if(x & 0x01) { // reinforce
+                    for(std::size_t i=0; (i<_a_np[a]) && (i<size); ++i) {
+                        std::size_t h=(head+i) % cap;
+                        scale(g, hx[h], hy[h], _weights[_a_P[a]+i]);
+                    }
+                }
+                if((x>>1) & 0x01) { // inhibit
+                    for(std::size_t i=0; (i<_a_nn[a]) && (i<size); ++i) {
+                        std::size_t h=(head+i) % cap;
+                        scale(g, hx[h], hy[h], _weights[_a_N[a]+i]);
+                    }
+                }
+            }
+            x = x >> 2; // lop off the two feedback bits
+
+            int y=sample(&_prob[_table[g] + x*_ncols[g]], _ncols[g]);
+            std::size_t t=(head+size) % cap;
+            hx[t] = x;
+            hy[t] = y;
+            ++size;
+            return y;
+        }
+
+        update_function_type _uf; //<! Update functor.
+        input_function_type _if; //<! Input functor.
+        rng_type _rng; //<! Random number generator.
+        std::size_t _nin, _nout, _nhid; //!< Number of inputs, outputs, and hidden state variables.
+        state_vector_type _T; //!< State vector for time t.
+        state_vector_type _Tplus1; //!< State vector for time t+1.
+
+        // per-gate arrays:
+        std::vector<unsigned char> _kind; //!< Type of each gate.
+        std::vector<std::size_t> _in_begin; //!< Offset of each gate's inputs in _in (ngates+1 entries).
+        std::vector<std::size_t> _in; //!< Input state indices for all gates.
+        std::vector<std::size_t> _out_begin; //!< Offset of each gate's outputs in _out (ngates+1 entries).
+        std::vector<std::size_t> _out; //!< Output state indices for all gates.
+        std::vector<std::size_t> _table; //!< Offset of each gate's table in _logic or _prob.
+        std::vector<std::size_t> _ncols; //!< Number of columns in each gate's probability table.
+        std::vector<std::size_t> _adaptive; //!< Index of each adaptive gate in the per-adaptive-gate arrays.
+        std::vector<int> _logic; //!< Logic gate truth tables.
+        std::vector<double> _prob; //!< Probabilistic and (working) adaptive gate tables, row-major.
+
+        // per-adaptive-gate arrays:
+        std::vector<unsigned char> _a_disabled; //!< Adaptation disabled if true.
+        std::vector<std::size_t> _a_h; //!< Size of history to keep.
+        std::vector<std::size_t> _a_q; //!< Offset of the pristine table in _q.
+        std::vector<std::size_t> _a_qsize; //!< Size of the pristine table.
+        std::vector<std::size_t> _a_P; //!< Offset of the positive feedback weights in _weights.
+        std::vector<std::size_t> _a_np; //!< Number of positive feedback weights.
+        std::vector<std::size_t> _a_N; //!< Offset of the negative feedback weights in _weights.
+        std::vector<std::size_t> _a_nn; //!< Number of negative feedback weights.
+        std::vector<std::size_t> _a_hist; //!< Offset of the history ring buffer in _hist_x and _hist_y.
+        std::vector<std::size_t> _a_hist_cap; //!< Capacity of the history ring buffer.
+        std::vector<std::size_t> _a_hist_head; //!< Index of the oldest history entry.
+        std::vector<std::size_t> _a_hist_size; //!< Number of history entries.
+        std::vector<double> _q; //!< Pristine adaptive gate tables.
+        std::vector<double> _weights; //!< Feedback weights.
+        std::vector<std::size_t> _hist_x; //!< History of adaptive gate inputs.
+        std::vector<int> _hist_y; //!< History of adaptive gate outputs.
+    };
+
+} // mkv
+
+#endif
@@ -121,6 +121,12 @@ namespace mkv {
             _rng.reset(seed);
         }
         
+        //! Retrieve this network's rng.
+        rng_type& rng() { return _rng; }
+
+        //! Retrieve this network's rng (const-qualified).
+        const rng_type& rng() const { return _rng; }
+
         //! Retrieve the size of this network, in number of gates.
         std::size_t ngates() const { return _gates.size(); }
         